@@ -202,6 +202,46 @@ public class TestSessionManager {
         }
     }
 
+    /**
+     Uploads a trimmed recording to Amazon S3 to initiate processing, streaming it from a `TrimmedWaveProducer` instead
+     of reading it from a trimmed file.  The producer analyses the recording in the background, so creating it before
+     calling this method lets the analysis overlap with the upload target request.
+
+     - Parameters:
+        - producer: The producer of the trimmed lung function test recording.
+        - completion: A callback closure that gets invoked after receiving the response from the upload request.
+            - error: The error that occurred while uploading the recording (Optional).
+
+     - Throws:
+        - `ClientError.unauthorized` if the `token` hasn't been set on the client.
+        - `NetworkError.unacceptableStatusCode` if an failure status code is received in the response.
+        - `TestSessionManagerError.uploadTargetCreationFailed` if the request to create a upload target failed.
+        - `TestSessionmanagerError.testUploadFailed` if uploading the test recording failed.
+
+     */
+    public func uploadRecording(streamingFrom producer: TrimmedWaveProducer,
+                                completion: @escaping (_ error: Swift.Error?) -> Void) {
+        getUploadTarget { (uploadTarget, error) in
+            guard let uploadTarget = uploadTarget else {
+                completion(error)
+                return
+            }
+
+            self.usedUploadTargetIds.append(uploadTarget.id)
+            self.client.uploadStream(from: producer, to: uploadTarget, completion: { error in
+
+                if let error = error {
+
+                    print("Test upload failed with error: \(error)")
+                    completion(TestSessionManagerError.testUploadFailed)
+                    return
+                }
+
+                completion(nil)
+            })
+        }
+    }
+
     fileprivate func getUploadTarget(completion: @escaping (UploadTarget?, Swift.Error?) -> Void) {
         if let uploadTarget = testSession.uploadTargets.filter({ !usedUploadTargetIds.contains($0.id) }).first {
             completion(uploadTarget, nil)
@@ -101,18 +101,47 @@ public class TestSessionRecorder {
     fileprivate var baselineBlowBackground = 0.5
     fileprivate let defaultBaselineBlow = 0.5
 
+    /**
+     The highest noise floor of a recording that is still considered a valid test, as a 16 bit sample amplitude. This
+     is the -10 dB full scale level above which `AmbientNoiseMonitor` considers the ambient noise too loud.
+     */
+    public let noiseFloorThreshold: Double = 32767 * pow(10, -10.0 / 20)
+
+    /**
+     The noise floor of the recording as a 16 bit sample amplitude. It is estimated in the same pass that trims the
+     recording for `recordingFilepath`, and is `nil` until the recording has been trimmed.
+     */
+    public fileprivate(set) var recordingNoiseFloor: Double?
+
+    /// Indicates whether the noise floor of the trimmed recording is below the `noiseFloorThreshold`.
+    public var noiseFloorThresholdPassed: Bool {
+        guard let noiseFloor = recordingNoiseFloor else { return false }
+
+        return noiseFloor < noiseFloorThreshold
+    }
+
     /// The filepath where the recording is saved to.
     public var recordingFilepath: String? {
+        var noiseFloor = 0.0
         if let soundFilePath = soundFilePath,
             let soundFileTrimmedPath = soundFileTrimmedPath,
-            TrimmingWrapper.trim(withInputFileName: soundFilePath, outputFileName: soundFilePath) == 0 {
+            TrimmingWrapper.trim(withInputFileName: soundFilePath, outputFileName: soundFilePath,
+                                 noiseFloor: &noiseFloor) == 0 {
 
+            recordingNoiseFloor = noiseFloor
             return soundFileTrimmedPath
         }
 
         return soundFilePath
     }
 
+    /// A producer that streams the trimmed recording without writing it to a file first.
+    public var recordingProducer: TrimmedWaveProducer? {
+        guard let soundFilePath = soundFilePath else { return nil }
+
+        return TrimmedWaveProducer(inputFileName: soundFilePath)
+    }
+
     fileprivate var soundFilePath: String?
     fileprivate var soundFileTrimmedPath: String?
 
@@ -199,6 +228,8 @@ public class TestSessionRecorder {
 
         guard state == .ready else { return }
 
+        recordingNoiseFloor = nil
+
         startAudioRecorder()
         startTestTimer()
 
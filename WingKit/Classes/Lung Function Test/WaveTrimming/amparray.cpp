@@ -82,16 +82,18 @@ int argMaxAmp(vector<char *> arr){
 // point being currently inspected is larger, it returns the current point being
 // inspected.  The logic here is that any jump or blip before the maximum point
 // of the amplitude array is noise, and therefore any data leading up to that
-// first found noise location can be trimmed. This function returns a 2D point
-// of the start trimming point.  The xcoordinate and ycoordinate refer to the
-// index and value (respectively) of the trimming start point.
+// first found noise location can be trimmed.  A point the smoothing zeroed is
+// silence, so the iteration also stops at the first such point instead of
+// running on through the flat silence before the effort. This function returns
+// a 2D point of the start trimming point.  The xcoordinate and ycoordinate
+// refer to the index and value (respectively) of the trimming start point.
 xyPoint determineStartPoint(vector<char *> smoothedAmpData, int maxInd){
 	xyPoint a;
 	int j = maxInd;
 	for (; j > 0 ; j--){
 		int post = atoi(smoothedAmpData[j - 1]);
 		int now = atoi(smoothedAmpData[j]);
-		if (post > now){
+		if (post > now || now == 0){
 			break;
 		}
 	}
@@ -174,3 +176,81 @@ int determineEndIndex(vector<char *> smoothedAmpData, int maxInd,
                                          allowedSilence);
 	return endPoint.xCoord;
 }
+
+// Determines the start and end indices of every effort in the amplitude data.
+// Where determineStartPoint and determineEndPoint find a single effort around
+// the global maximum, this function finds all efforts in one continuous
+// recording with a single forward pass.  An effort opens at the first non-zero
+// point of the smoothed data and tracks its own running maximum.  It closes
+// once 'allowedSilence' consecutive points fall beneath 'percent' of that
+// running maximum, the same rule determineEndPoint applies to the global
+// maximum.  The start index of each effort is then found the same way as in
+// determineStartPoint, by iterating backwards from the effort's maximum, but
+// never past the point where the effort opened.  The silence before that
+// point belongs to no effort, and stopping there keeps the ranges from
+// overlapping.  Since each backwards walk is confined to the effort itself,
+// the whole function runs in linear time.
+// Efforts whose maximum is beneath 'minPeakPercent' of the global maximum are
+// considered noise and discarded.
+vector<effortRange> determineEffortRanges(vector<char *> smoothedAmpData,
+							double percent, int allowedSilence,
+							double minPeakPercent){
+	vector<effortRange> efforts;
+	int size = (int) smoothedAmpData.size();
+	if (size == 0){
+		return efforts;
+	}
+	vector<int> amp(size);
+	int globalMax = 0;
+	for (int i = 0; i < size; i++){
+		amp[i] = atoi(smoothedAmpData[i]);
+		globalMax = max(globalMax, amp[i]);
+	}
+	double minPeak = minPeakPercent * globalMax;
+
+	bool inEffort = false;
+	int peakVal = 0;
+	int peakInd = 0;
+	int silentPts = 0;
+	int firstInd = 0;
+	for (int i = 0; i < size; i++){
+		if (!inEffort){
+			if (amp[i] <= 0){
+				continue;
+			}
+			inEffort = true;
+			firstInd = i;
+			peakVal = amp[i];
+			peakInd = i;
+			silentPts = 0;
+		}
+		if (amp[i] > peakVal){
+			peakVal = amp[i];
+			peakInd = i;
+		}
+		bool silent = amp[i] < percent * peakVal;
+		if (silent){
+			silentPts += 1;
+		}
+		else{
+			silentPts = 0;
+		}
+		bool last = (i == size - 1);
+		if (silentPts >= allowedSilence || last){
+			inEffort = false;
+			if (peakVal > 0 && peakVal >= minPeak){
+				int j = peakInd;
+				for (; j > firstInd; j--){
+					if (amp[j - 1] > amp[j]){
+						break;
+					}
+				}
+				effortRange effort;
+				effort.startInd = j;
+				effort.endInd = i;
+				efforts.push_back(effort);
+			}
+		}
+	}
+	return efforts;
+}
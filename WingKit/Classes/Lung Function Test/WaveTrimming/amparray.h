@@ -17,6 +17,13 @@ struct xyPoint{
 	int yCoord;
 };
 
+// Struct of ints.  This encapsulates a single effort found in the amplitude
+// array, i.e. the indices of its start and end trimming points.
+struct effortRange{
+	int startInd;
+	int endInd;
+};
+
 // Reads amplitude data froma  file.
 vector<char*> readAmpDataFile(string & fname);
 
@@ -40,4 +47,10 @@ xyPoint determineEndPoint(vector<char *> smoothedAmpData, int maxInd,
 int determineEndIndex(vector<char *> smoothedAmpData, int maxInd,
 						double percent = 0.1, int allowedSilence = 10);
 
+// Determines the start and end indices of every effort in the amplitude
+// array.  Returns the non-overlapping ranges in time order.
+vector<effortRange> determineEffortRanges(vector<char *> smoothedAmpData,
+							double percent = 0.1, int allowedSilence = 10,
+							double minPeakPercent = 0.25);
+
 #endif
@@ -0,0 +1,82 @@
+// This source file defines the functions used to estimate the noise floor of
+// a recording from its amplitude data.
+//
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "noiseFloor.h"
+
+using namespace std;
+
+// Returns the exact p quantile of a set of values, or 0 if there are none.
+// The quantile is selected in place with nth_element, so the values are
+// reordered but never fully sorted.
+double exactQuantile(vector<int> &values, double p){
+	if (values.empty()){
+		return 0;
+	}
+	vector<int>::iterator nth = values.begin() +
+		(int) (p * (values.size() - 1));
+	nth_element(values.begin(), nth, values.end());
+	return *nth;
+}
+
+// Estimates the noise floor of a recording from its amplitude data.  The
+// background noise sets the level of the amplitude data wherever the user is
+// not blowing, which is usually the bulk of a recording, and since every
+// point is the maximum of a chunk, the points of the noise lie close together
+// just beneath its peak.  A low quantile of the amplitude data is therefore a
+// robust estimate of the noise level that is not pulled up by the effort, and
+// the noise threshold is that level times a safety margin, which lifts it
+// clear of the noise.  The smoothing threshold is the noise threshold, but
+// never lower than 'minThreshold', so that recordings made in a quiet
+// environment are smoothed exactly as before.
+// A recording can however be mostly effort, in which case the quantile falls
+// within the effort and the noise threshold would reach half the peak.  The
+// level is then estimated again from the points beneath 'minPercent' of the
+// peak only, i.e. from the silence determineEndPoint finds around the effort.
+// If there are no such points, the noise cannot be told apart from the effort
+// and the recording is smoothed as before, while the level is still reported.
+// The points the smoothing zeroes are the noise, so in a noisy recording an
+// effort is over once the amplitude falls back beneath the noise threshold.
+// This is reported as 'silencePercent', the noise threshold as a fraction of
+// the peak, but never less than 'minPercent', the fraction used before, so a
+// quiet recording still ends where it did.
+noiseFloorEstimate estimateNoiseFloor(vector<char *> ampData,
+	int minThreshold, double quantile, double margin, double minPercent){
+	vector<int> values(ampData.size());
+	int peak = 0;
+	for (unsigned int i = 0; i < ampData.size(); i++){
+		values[i] = atoi(ampData[i]);
+		peak = max(peak, values[i]);
+	}
+	noiseFloorEstimate estimate;
+	estimate.level = exactQuantile(values, quantile);
+	double noiseThreshold = margin * estimate.level;
+
+	if (noiseThreshold >= 0.5 * peak){
+		//the quantile fell within the effort, estimate from the silence only
+		vector<int> quiet;
+		for (unsigned int i = 0; i < values.size(); i++){
+			if (values[i] < minPercent * peak){
+				quiet.push_back(values[i]);
+			}
+		}
+		if (quiet.empty()){
+			noiseThreshold = 0;
+		}
+		else{
+			estimate.level = exactQuantile(quiet, quantile);
+			noiseThreshold = margin * estimate.level;
+		}
+	}
+	estimate.threshold = max(minThreshold, (int) noiseThreshold);
+	estimate.silencePercent = minPercent;
+	if (peak > 0){
+		estimate.silencePercent = max(minPercent, noiseThreshold / peak);
+	}
+	return estimate;
+}
@@ -0,0 +1,30 @@
+// This header file declares the functions used to estimate the noise floor of
+// a recording from its amplitude data, so that the smoothing threshold and the
+// level at which an effort is considered over can be derived per recording
+// instead of being fixed.
+//
+
+#ifndef NOISEFLOOR_H
+#define NOISEFLOOR_H
+
+#include <vector>
+
+using namespace std;
+
+// Struct holding the noise floor estimated for a recording.
+struct noiseFloorEstimate{
+	double level; // estimated amplitude of the background noise
+	int threshold; // smoothing threshold derived from the noise level
+	double silencePercent; // fraction of the peak beneath which a point is silent
+};
+
+// Returns the exact p quantile of a set of values, or 0 if there are none.
+// The values are reordered.
+double exactQuantile(vector<int> &values, double p);
+
+// Estimates the noise floor of a recording from its amplitude data.
+noiseFloorEstimate estimateNoiseFloor(vector<char *> ampData,
+	int minThreshold = 100, double quantile = 0.25, double margin = 2.0,
+	double minPercent = 0.1);
+
+#endif
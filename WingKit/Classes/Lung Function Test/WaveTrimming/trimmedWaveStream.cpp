@@ -0,0 +1,131 @@
+// This source file defines the pull based producer for the trimmed wave file.
+// The trimming points are determined with the same processing cascade used by
+// trim(), but instead of buffering the trimmed data and writing it to a new
+// file, the producer seeks to the trimming start point and reads the input
+// file forward as chunks are requested.
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "wavdata.h"
+#include "waveIO.h"
+#include "waveTrimming.h"
+#include "noiseFloor.h"
+#include "trimmedWaveStream.h"
+
+using namespace std;
+
+// Opens a trimmed wave stream.  This function reads the input wave file to
+// build the amplitude data and determine the trimming points, exactly as
+// trim() does.  The trimming points are then scaled to byte offsets in the
+// sound data (4 bytes per sample, 2 channels of shorts), the header is updated
+// to describe the trimmed data and packed, and the read offset is set to the
+// trimming start point.  No sound data is buffered beyond what is
+// needed to determine the trimming points.  The input file is then opened on
+// a backend created for and owned by the stream.
+int openTrimmedWaveStream(string inputFileName, trimmedWaveStream &stream){
+	stream.hasIO = false;
+	stream.fd = -1;
+	stream.headerPos = 44;
+	stream.remaining = 0;
+	stream.dataSize = 0;
+	stream.failed = false;
+	waveFileStruct waveFile;
+	try {
+		waveFile = readWaveData(inputFileName, true);
+	}
+	catch (const invalid_argument& e) {
+		return 1;
+	}
+	vector<char*> rawAmpData = constructAmpData(waveFile);
+	noiseFloorEstimate noise = estimateNoiseFloor(rawAmpData);
+	vector<int> soundTrimmingPoints = getTrimmingPoints(rawAmpData,
+		noise.threshold, noise.silencePercent);
+
+	long start_point = (long) soundTrimmingPoints[0] * 4;
+	long end_point = (long) soundTrimmingPoints[1] * 4;
+	//the padded end point may run past the recorded data, keep it in bounds
+	end_point = min(end_point, waveFile.subChunk3Size);
+	start_point = min(start_point, end_point);
+
+	//update the header to describe the trimmed data only
+	long pre_start = start_point;
+	long post_end = waveFile.subChunk3Size - end_point;
+	waveFile.fileSize = waveFile.fileSize - (pre_start + post_end);
+	waveFile.subChunk3Size = end_point - start_point;
+	packWaveHeader(waveFile, stream.header);
+	stream.headerPos = 0;
+	stream.remaining = waveFile.subChunk3Size;
+	stream.dataSize = waveFile.subChunk3Size;
+
+	stream.offset = waveFile.dataOffset + start_point;
+	createDefaultWaveIOBackend(stream.io);
+	stream.hasIO = true;
+	stream.fd = stream.io.openFile(stream.io.context, inputFileName.c_str(),
+		false);
+	if (stream.fd < 0){
+		stream.remaining = 0;
+		return 1;
+	}
+	return 0;
+}
+
+// Returns the size in bytes of the trimmed wave file, header included.  This
+// is known as soon as the stream is open, so it can be sent ahead of the data,
+// e.g. as the content length of an upload.
+long trimmedWaveStreamLength(trimmedWaveStream &stream){
+	return 44 + stream.dataSize;
+}
+
+// Copies the next chunk of the trimmed wave file.  The header is handed out
+// first, followed by the trimmed sound data read straight from the input
+// file.  A chunk never exceeds maxBytes.  The header promises exactly
+// 'dataSize' bytes of sound data, so a failed or short read of the input file
+// is reported as an error rather than silently ending the stream, and every
+// later call fails as well.
+long readTrimmedWaveChunk(trimmedWaveStream &stream, char * buffer,
+	long maxBytes){
+	if (stream.failed){
+		return -1;
+	}
+	long copied = 0;
+	if (stream.headerPos < 44){
+		long n = min(maxBytes, (long) (44 - stream.headerPos));
+		memcpy(buffer, stream.header + stream.headerPos, n);
+		stream.headerPos += n;
+		copied += n;
+	}
+	long n = min(maxBytes - copied, stream.remaining);
+	if (n > 0){
+		long got = -1;
+		if (stream.fd >= 0){
+			got = waveIORead(stream.io, stream.fd, buffer + copied, n,
+				stream.offset);
+		}
+		if (got != n){
+			stream.failed = true;
+			return -1;
+		}
+		stream.offset += got;
+		stream.remaining -= got;
+		copied += got;
+	}
+	return copied;
+}
+
+// Closes the input file backing the stream and releases its I/O backend.
+void closeTrimmedWaveStream(trimmedWaveStream &stream){
+	stream.remaining = 0;
+	if (stream.fd >= 0){
+		stream.io.closeFile(stream.io.context, stream.fd);
+		stream.fd = -1;
+	}
+	if (stream.hasIO){
+		destroyWaveIOBackend(stream.io);
+		stream.hasIO = false;
+	}
+}
@@ -0,0 +1,50 @@
+// This header file declares a pull based producer for the trimmed wave file.
+// Rather than writing the whole trimmed recording to disk before it can be
+// uploaded, the producer hands out the trimmed header and sound data a chunk
+// at a time, so the caller can stream the output while it is being read.
+//
+
+#ifndef TRIMMEDWAVESTREAM_H
+#define TRIMMEDWAVESTREAM_H
+
+#include <string>
+
+#include "waveIO.h"
+
+using namespace std;
+
+// Struct holding the state of a trimmed wave stream.  The header is packed
+// once the trimming points are known, after which the sound data between the
+// trimming points is read directly from the input file on demand.  The stream
+// owns the I/O backend its input file was opened on, so chunks can be pulled
+// from a different thread than the one that opened the stream, as long as
+// only one thread uses the stream at a time.
+struct trimmedWaveStream{
+	waveIOBackend io; // backend owned by the stream, created when it is opened
+	bool hasIO; // set while the stream owns a backend
+	int fd; // input file descriptor from the stream's I/O backend
+	long offset; // byte offset of the next sound data byte in the input file
+	char header[44]; // header of the trimmed wave file
+	int headerPos; // number of header bytes already handed out
+	long remaining; // number of trimmed sound data bytes left to hand out
+	long dataSize; // number of trimmed sound data bytes in total
+	bool failed; // set once a read of the input file fails
+};
+
+// Opens a trimmed wave stream over the passed input file.  Returns 0 on
+// success and 1 if the input file could not be read.
+int openTrimmedWaveStream(string inputFileName, trimmedWaveStream &stream);
+
+// Returns the size in bytes of the trimmed wave file, header included.
+long trimmedWaveStreamLength(trimmedWaveStream &stream);
+
+// Copies the next chunk of the trimmed wave file into buffer.  Returns the
+// number of bytes copied, 0 once the whole file has been handed out, or -1 if
+// the input file could not be read.
+long readTrimmedWaveChunk(trimmedWaveStream &stream, char * buffer,
+	long maxBytes);
+
+// Closes the input file backing the stream and releases its I/O backend.
+void closeTrimmedWaveStream(trimmedWaveStream &stream);
+
+#endif
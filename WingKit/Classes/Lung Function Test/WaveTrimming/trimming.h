@@ -15,6 +15,32 @@
 
 + (int)trimWithInputFileName:(NSString*)inputFileName
               outputFileName:(NSString*) outputFileName;
+
++ (int)trimWithInputFileName:(NSString*)inputFileName
+              outputFileName:(NSString*)outputFileName
+                  noiseFloor:(double*)noiseFloor;
+
++ (int)trimEffortsWithInputFileName:(NSString*)inputFileName
+                     outputFileName:(NSString*)outputFileName
+                        effortCount:(int*)effortCount;
+@end
+
+extern NSString * const TrimmedWaveProducerErrorDomain;
+
+typedef NS_ENUM(NSInteger, TrimmedWaveProducerError) {
+    TrimmedWaveProducerErrorInvalidLength = 1,
+    TrimmedWaveProducerErrorOpenFailed,
+    TrimmedWaveProducerErrorReadFailed
+};
+
+@interface TrimmedWaveProducer : NSObject
+
+- (instancetype)initWithInputFileName:(NSString*)inputFileName;
+
+- (long long)expectedLength;
+
+- (NSData*)nextChunkWithMaxLength:(NSUInteger)maxLength
+                            error:(NSError**)error;
 @end
 
 #endif /* trimming_h */
@@ -6,8 +6,11 @@
 //  Copyright (c) 2015 Sparo, Inc. All rights reserved.
 //
 
+#include <memory>
+
 #include "trimming.h"
 #include "waveTrimming.h"
+#include "trimmedWaveStream.h"
 
 @implementation TrimmingWrapper
 
@@ -18,4 +21,110 @@
     return trim(inputPathNameString, outputPathNameString);
 }
 
++ (int)trimWithInputFileName:(NSString*)inputFileName
+              outputFileName:(NSString*)outputFileName
+                  noiseFloor:(double*)noiseFloor {
+    std::string inputPathNameString([inputFileName UTF8String]);
+    std::string outputPathNameString([outputFileName UTF8String]);
+    double estimatedNoiseFloor = 0;
+    int result = trim(inputPathNameString, outputPathNameString, estimatedNoiseFloor);
+    if (noiseFloor) {
+        *noiseFloor = estimatedNoiseFloor;
+    }
+    return result;
+}
+
++ (int)trimEffortsWithInputFileName:(NSString*)inputFileName
+                     outputFileName:(NSString*)outputFileName
+                        effortCount:(int*)effortCount {
+    std::string inputPathNameString([inputFileName UTF8String]);
+    std::string outputPathNameString([outputFileName UTF8String]);
+    int writtenEffortCount = 0;
+    int result = trimEfforts(inputPathNameString, outputPathNameString, writtenEffortCount);
+    if (effortCount) {
+        *effortCount = writtenEffortCount;
+    }
+    return result;
+}
+
+@end
+
+NSString * const TrimmedWaveProducerErrorDomain = @"TrimmedWaveProducerErrorDomain";
+
+// The stream of a producer and the result of opening it.  The state is shared between the producer and its
+// background analysis, so the producer can be released before the analysis has finished: whichever of the two lets
+// go of the state last closes the stream.
+struct trimmedWaveProducerState {
+    trimmedWaveStream stream;
+    int openResult;
+
+    trimmedWaveProducerState() : openResult(1) {
+        stream.hasIO = false;
+        stream.fd = -1;
+    }
+
+    ~trimmedWaveProducerState() {
+        closeTrimmedWaveStream(stream);
+    }
+};
+
+@implementation TrimmedWaveProducer {
+    std::shared_ptr<trimmedWaveProducerState> _state;
+    dispatch_group_t _analysis;
+}
+
+- (instancetype)initWithInputFileName:(NSString*)inputFileName {
+    self = [super init];
+    if (self) {
+        std::string inputPathNameString([inputFileName UTF8String]);
+        std::shared_ptr<trimmedWaveProducerState> state = std::make_shared<trimmedWaveProducerState>();
+        _state = state;
+        _analysis = dispatch_group_create();
+        // The analysis runs in the background so it overlaps with whatever the caller does before pulling the
+        // first chunk, e.g. requesting an upload target.  The block holds the state rather than self, so releasing
+        // the producer never has to wait for the analysis.
+        dispatch_group_async(_analysis, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            state->openResult = openTrimmedWaveStream(inputPathNameString, state->stream);
+        });
+    }
+    return self;
+}
+
+- (long long)expectedLength {
+    dispatch_group_wait(_analysis, DISPATCH_TIME_FOREVER);
+    if (_state->openResult != 0) {
+        return -1;
+    }
+    return trimmedWaveStreamLength(_state->stream);
+}
+
+- (NSData*)nextChunkWithMaxLength:(NSUInteger)maxLength error:(NSError**)error {
+    if (maxLength == 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:TrimmedWaveProducerErrorDomain
+                                         code:TrimmedWaveProducerErrorInvalidLength userInfo:nil];
+        }
+        return nil;
+    }
+    dispatch_group_wait(_analysis, DISPATCH_TIME_FOREVER);
+    if (_state->openResult != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:TrimmedWaveProducerErrorDomain
+                                         code:TrimmedWaveProducerErrorOpenFailed userInfo:nil];
+        }
+        return nil;
+    }
+    NSMutableData *chunk = [NSMutableData dataWithLength:maxLength];
+    long length = readTrimmedWaveChunk(_state->stream, (char *) chunk.mutableBytes, (long) maxLength);
+    if (length < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:TrimmedWaveProducerErrorDomain
+                                         code:TrimmedWaveProducerErrorReadFailed userInfo:nil];
+        }
+        return nil;
+    }
+    chunk.length = length;
+    return chunk;
+}
+
 @end
@@ -1,110 +1,140 @@
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 #include "wavdata.h"
+#include "waveIO.h"
 
 using namespace std;
 
-// This function reads in a wave file.  In particular, it opens an input wave
-// file and first extracts the information stored in the header (format,
-// bitrate, etc.).  Then it parses the actual recorded audio and stores
-// that data in one of two ways.  If 'initial_read' is true, the recorded
-// data is stored in a vector of shorts.  This is later used to reverse
-// engineer the amplitude data (the maximum data point at each chunk of the
-// sound data array) which is then used to determine points by which to trim
-// the wave file.  If 'initial_read is false, then the data is stored into a
-// char * array, which makes it easier to be written back into a new wave
-// file.  The function returns a waveFileStruct which is a struct that holds
-// the header info as well as the stored data.
-waveFileStruct readWaveData(string fname, bool initial_read, bool debug) {
-	ifstream ifs(fname, ifstream::binary);
+// This function parses a wave file held in memory.  In particular, it first
+// extracts the information stored in the header (format, bitrate, etc.).
+// Then it parses the actual recorded audio and stores that data in one of two
+// ways.  If 'initial_read' is true, the recorded data is stored in a vector of
+// shorts.  This is later used to reverse engineer the amplitude data (the
+// maximum data point at each chunk of the sound data array) which is then
+// used to determine points by which to trim the wave file.  If 'initial_read
+// is false, then the data is copied into a char * array, which makes it
+// easier to be written back into a new wave file.  A header or sound data
+// that runs past the end of the bytes is reported with an invalid_argument
+// exception, the same way a recording without data is.
+waveFileStruct parseWaveData(const char * bytes, long size, bool initial_read,
+	bool debug) {
 	waveFileStruct wav_file = {};
-	if (ifs.is_open())
-	{
-		/*Read Header Info*/
-		ifs.read(wav_file.chunkID, 4);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.fileSize), 4);
-
-        ifs.read(wav_file.format, 4);
-
-		ifs.read(wav_file.subChunk1ID, 4);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.subChunk1Size), 4);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.audioFormat), 2);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.numChannels), 2);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.sampleRate), 4);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.byteRate), 4);
 
-		ifs.read(reinterpret_cast<char*>(&wav_file.blockAlign), 2);
-
-		ifs.read(reinterpret_cast<char*>(&wav_file.bitsPerSample), 2);
+	/*Read Header Info*/
+	if (size < 44) {
+		throw invalid_argument("Truncated header");
+	}
+	unpackWaveHeader(bytes, wav_file);
+	long offset = 44;
+
+	//Some wave recordings contain filler data.  If this one does, skip it
+	//and update the data being read in
+	if (string(wav_file.subChunk3ID).compare("FLLR") == 0){
+		wav_file.fileSize -= wav_file.subChunk3Size;
+		offset += wav_file.subChunk3Size;
+		if (offset + 8 > size) {
+			throw invalid_argument("Truncated header");
+		}
+		memcpy(wav_file.subChunk3ID, bytes + offset, 4);
+		memcpy(&wav_file.subChunk3Size, bytes + offset + 4, 4);
+		offset += 8;
+	}
 
-		ifs.read(wav_file.subChunk3ID, 4);
+	//remember where the sound data starts so it can be read back later
+	wav_file.dataOffset = offset;
 
-		ifs.read(reinterpret_cast<char*>(&wav_file.subChunk3Size), 4);
+	// Check to ses if any data exists
+	if (wav_file.subChunk3Size == 0) {
+		throw invalid_argument("No data");
+	}
+	if (wav_file.dataOffset + wav_file.subChunk3Size > size) {
+		throw invalid_argument("Truncated data");
+	}
 
-		//Some wave recordings contain filler data.  If this one does, skip it
-		//and update the data being read in
-		if (string(wav_file.subChunk3ID).compare("FLLR") == 0){
-			wav_file.fileSize -= wav_file.subChunk3Size;
-			ifs.seekg(wav_file.subChunk3Size + ifs.tellg());
-			ifs.read(wav_file.subChunk3ID, 4);
-			ifs.read(reinterpret_cast<char*>(&wav_file.subChunk3Size), 4);
+	/*Read in the audio data*/
+	const char * sound = bytes + wav_file.dataOffset;
+	if (initial_read){
+		//Data being read into a short vector
+		int raw_data_size = (int) wav_file.subChunk3Size / 2; //Only need one channel
+		wav_file.data.reserve(raw_data_size / 2 + 1);
+		//parse the samples of the first channel into a vector
+		int i = 0;
+		while (i < raw_data_size){
+			short sample;
+			memcpy(&sample, sound + 2 * i, 2);
+			wav_file.data.push_back(sample);
+			i += 2;
 		}
+	}
+	else{
+		// data being copied in to a char array
+		wav_file.raw_data = new char[wav_file.subChunk3Size];
+		memcpy(wav_file.raw_data, sound, wav_file.subChunk3Size);
+	}
 
-		// Check to ses if any data exists
-		if (wav_file.subChunk3Size == 0) {
-			throw invalid_argument("No data");
-		}
+	//If debug flag is true, print out info about the wave file
+	if (debug){
+
+		cout << "Chunk Descriptor : " << wav_file.chunkID << endl
+			<< "File_Size : " << wav_file.fileSize << endl
+			<< "format : " << wav_file.format << endl
+			<< "fmt subchunk name : " << wav_file.subChunk1ID << endl
+			<< "subChunk1Size : " << wav_file.subChunk1Size << endl
+			<< "audio format (pcm=1): " << wav_file.audioFormat << endl
+			<< "num channels: " << wav_file.numChannels << endl
+			<< "sampleRate : " << wav_file.sampleRate << endl
+			<< "byteRate : " << wav_file.byteRate << endl
+			<< "blockAlign :" << wav_file.blockAlign << endl
+			<< "bits per sample: " << wav_file.bitsPerSample << endl
+			<< "subChunk3ID : " << wav_file.subChunk3ID << endl
+			<< "subChunk3Size : " << wav_file.subChunk3Size << endl
+			<< "Data gcount : " << wav_file.subChunk3Size << endl << endl;
+	}
+	return wav_file;
+}
 
-		/*Read in the audio data*/
-		if (initial_read){
-			//Data being read into a short vector
-			int raw_data_size = (int) wav_file.subChunk3Size / 2; //Only need one channel
-			short * raw_data = new short[raw_data_size];
-			ifs.read(reinterpret_cast<char*>(raw_data), wav_file.subChunk3Size);
-
-			//parse the read in data file into a vector
-			int i = 0;
-			while (i < raw_data_size){
-				wav_file.data.push_back(raw_data[i]);
-				i += 2;
-			}
-			//clean up
-			delete[] raw_data;
-		}
-		else{
-			// data being read in to a char array
-			wav_file.raw_data = new char[wav_file.subChunk3Size];
-			ifs.read(wav_file.raw_data, wav_file.subChunk3Size);
-		}
+// This function reads a whole file into memory.  The file is fetched from
+// the I/O backend with a single read, so the header and the sound data cost
+// one request rather than one per field, and a caller that needs the sound
+// data in more than one form can parse the same bytes again instead of
+// reading the file twice.  A file that cannot be opened or read in full is
+// reported with an invalid_argument exception.  Returns a new[] allocated
+// buffer, whose size is stored in 'size'.
+char * readWaveFile(string fname, long &size) {
+	waveIOBackend &io = currentWaveIOBackend();
+	int fd = io.openFile(io.context, fname.c_str(), false);
+	if (fd < 0) {
+		throw invalid_argument("Cannot open file");
+	}
+	size = waveIOFileSize(fd);
+	char * bytes = new char[max(size, 0L)];
+	long bytesRead = (size >= 0) ? waveIORead(io, fd, bytes, size, 0) : -1;
+	io.closeFile(io.context, fd);
+	if (bytesRead < 0 || bytesRead != size) {
+		delete[] bytes;
+		throw invalid_argument("Read failed");
+	}
+	return bytes;
+}
 
-		//If debug flag is true, print out info about the wave file
-		if (debug){
-
-			cout << "Chunk Descriptor : " << wav_file.chunkID << endl
-				<< "File_Size : " << wav_file.fileSize << endl
-				<< "format : " << wav_file.format << endl
-				<< "fmt subchunk name : " << wav_file.subChunk1ID << endl
-				<< "subChunk1Size : " << wav_file.subChunk1Size << endl
-				<< "audio format (pcm=1): " << wav_file.audioFormat << endl
-				<< "num channels: " << wav_file.numChannels << endl
-				<< "sampleRate : " << wav_file.sampleRate << endl
-				<< "byteRate : " << wav_file.byteRate << endl
-				<< "blockAlign :" << wav_file.blockAlign << endl
-				<< "bits per sample: " << wav_file.bitsPerSample << endl
-				<< "subChunk3ID : " << wav_file.subChunk3ID << endl
-				<< "subChunk3Size : " << wav_file.subChunk3Size << endl
-				<< "Data gcount : " << ifs.gcount() << endl << endl;
-		}
+// This function reads in a wave file with readWaveFile and parses it with
+// parseWaveData.  The function returns a waveFileStruct which is a struct
+// that holds the header info as well as the stored data.
+waveFileStruct readWaveData(string fname, bool initial_read, bool debug) {
+	long size;
+	char * bytes = readWaveFile(fname, size);
+	waveFileStruct wav_file;
+	try {
+		wav_file = parseWaveData(bytes, size, initial_read, debug);
+	}
+	catch (const invalid_argument& e) {
+		delete[] bytes;
+		throw;
 	}
+	delete[] bytes;
 	return wav_file;
 }
 
@@ -160,26 +190,62 @@ vector<char *> constructAmpData(waveFileStruct &wave_file, int chunk_size){
 }
 
 
-// Writes a new wave file.  This function takes in a name (which will be used
-// as the file name that will be saved, a waveFileStruct that holds the
-// relevant wave file information, and a vector of two trimming points, which
-// will be used to trim the data.  Using the data stored in the waveFileStruct,
-// the function then creates a new array that contains only data between the
-// trimming points.  Then it updates the information regarding file sizes in
-// waveFileStruct and writes that info to a new wave file.
-int writeWaveFile(string fname, waveFileStruct &wav_file, vector<int> wave_trim_points){
+// Packs the header of a wave file.  This function lays out the header info
+// stored in the waveFileStruct in the same order and with the same field
+// widths that writeWaveFile uses, producing the 44 bytes that precede the
+// sound data.  The header buffer must be able to hold 44 bytes.
+void packWaveHeader(waveFileStruct &wav_file, char * header){
+	memcpy(header, wav_file.chunkID, 4);
+	memcpy(header + 4, &wav_file.fileSize, 4);
+	memcpy(header + 8, wav_file.format, 4);
+	memcpy(header + 12, wav_file.subChunk1ID, 4);
+	memcpy(header + 16, &wav_file.subChunk1Size, 4);
+	memcpy(header + 20, &wav_file.audioFormat, 2);
+	memcpy(header + 22, &wav_file.numChannels, 2);
+	memcpy(header + 24, &wav_file.sampleRate, 4);
+	memcpy(header + 28, &wav_file.byteRate, 4);
+	memcpy(header + 32, &wav_file.blockAlign, 2);
+	memcpy(header + 34, &wav_file.bitsPerSample, 2);
+	memcpy(header + 36, wav_file.subChunk3ID, 4);
+	memcpy(header + 40, &wav_file.subChunk3Size, 4);
+}
 
-	//start and end points need to be multiplied by 4 to scale from
-	//sound data stored as shorts to sound data stored as char *
-	// in 2 channels.
-	int start_point = wave_trim_points[0] * 4;
-	int end_point = wave_trim_points[1] * 4;
-	//new array to hold trimmed data
-	char * trimmed_data = new char[end_point - start_point];
-	//store trimmed data to new array
-	for (int i = start_point; i < end_point; i++){
-		trimmed_data[i - start_point] = wav_file.raw_data[i];
-	}
+
+// Unpacks the header of a wave file.  This is the inverse of packWaveHeader,
+// filling the header fields of the waveFileStruct from the 44 bytes at the
+// start of a wave file.  The 4 character IDs are null terminated.
+void unpackWaveHeader(const char * header, waveFileStruct &wav_file){
+	memcpy(wav_file.chunkID, header, 4);
+	memcpy(&wav_file.fileSize, header + 4, 4);
+	memcpy(wav_file.format, header + 8, 4);
+	memcpy(wav_file.subChunk1ID, header + 12, 4);
+	memcpy(&wav_file.subChunk1Size, header + 16, 4);
+	memcpy(&wav_file.audioFormat, header + 20, 2);
+	memcpy(&wav_file.numChannels, header + 22, 2);
+	memcpy(&wav_file.sampleRate, header + 24, 4);
+	memcpy(&wav_file.byteRate, header + 28, 4);
+	memcpy(&wav_file.blockAlign, header + 32, 2);
+	memcpy(&wav_file.bitsPerSample, header + 34, 2);
+	memcpy(wav_file.subChunk3ID, header + 36, 4);
+	memcpy(&wav_file.subChunk3Size, header + 40, 4);
+	wav_file.chunkID[4] = 0;
+	wav_file.format[4] = 0;
+	wav_file.subChunk1ID[4] = 0;
+	wav_file.subChunk3ID[4] = 0;
+}
+
+
+// Assembles the wave file holding the sound data between two byte offsets of
+// the raw data stored in the waveFileStruct.  The file size info in the
+// waveFileStruct is updated to describe the trimmed data, and the header and
+// trimmed data are placed in one new[] allocated buffer, whose size is
+// stored in output_size, so the whole file can be handed to the I/O backend
+// in a single write.
+char * packTrimmedWaveFile(waveFileStruct &wav_file, int start_point,
+	int end_point, long &output_size){
+	//the padded end point may run past the recorded data, keep it in bounds
+	end_point = min(end_point, (int) wav_file.subChunk3Size);
+	start_point = min(start_point, end_point);
 
 	//calculate amount to subtract from file size stored in
 	//wave file struct that will be written to new wave file
@@ -188,48 +254,77 @@ int writeWaveFile(string fname, waveFileStruct &wav_file, vector<int> wave_trim_
 	wav_file.fileSize = wav_file.fileSize - (pre_start + post_end);
 	//update size of sound data to match size of trimmed data
 	wav_file.subChunk3Size = end_point - start_point;
-	//create save name to save new wave file as
-	char* bname = new char[fname.size() - 3];
-	bname[fname.size() - 4] = 0;
-	memcpy(bname, fname.c_str(), fname.size() - 4);
-	string wavename(bname);
-	wavename += "-trimmed.wav";
-
-	//open the output stream for writing
-	ofstream ofs(wavename, ofstream::binary);
 
-	if (ofs.is_open()){
-		/*Write wave file header info*/
-		ofs.write(wav_file.chunkID, 4);
-
-		ofs.write(reinterpret_cast<char*>(&wav_file.fileSize), 4);
-
-        ofs.write(wav_file.format, 4);
-
-		ofs.write(wav_file.subChunk1ID, 4);
+	//new array to hold the header followed by the trimmed data
+	output_size = 44 + wav_file.subChunk3Size;
+	char * output_data = new char[output_size];
+	packWaveHeader(wav_file, output_data);
+	memcpy(output_data + 44, wav_file.raw_data + start_point,
+		wav_file.subChunk3Size);
+	return output_data;
+}
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.subChunk1Size), 4);
+// Writes the samples between start_point and end_point of wav_file out as a
+// new wave file.  Returns 0 on success and 1 if the file could not be written.
+static int writeTrimmedData(string wavename, waveFileStruct &wav_file,
+	int start_point, int end_point){
+	long output_size;
+	char * output_data = packTrimmedWaveFile(wav_file, start_point, end_point,
+		output_size);
+
+	//open the output file and write it out
+	waveIOBackend &io = currentWaveIOBackend();
+	int fd = io.openFile(io.context, wavename.c_str(), true);
+	long written = -1;
+	if (fd >= 0){
+		written = waveIOWrite(io, fd, output_data, output_size, 0);
+		io.closeFile(io.context, fd);
+	}
+	delete[] output_data;
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.audioFormat), 2);
+	return (written == output_size) ? 0 : 1;
+}
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.numChannels), 2);
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.sampleRate), 4);
+// Writes a new wave file.  This function takes in a name (which will be used
+// as the file name that will be saved, a waveFileStruct that holds the
+// relevant wave file information, and a vector of two trimming points, which
+// will be used to trim the data.  Using the data stored in the waveFileStruct,
+// the function then creates a new array that contains only data between the
+// trimming points.  Then it updates the information regarding file sizes in
+// waveFileStruct and writes that info to a new wave file.
+int writeWaveFile(string fname, waveFileStruct &wav_file, vector<int> wave_trim_points){
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.byteRate), 4);
+	//start and end points need to be multiplied by 4 to scale from
+	//sound data stored as shorts to sound data stored as char *
+	// in 2 channels.
+	int start_point = wave_trim_points[0] * 4;
+	int end_point = wave_trim_points[1] * 4;
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.blockAlign), 2);
+	//create save name to save new wave file as
+	string wavename = fname.substr(0, fname.size() - 4) + "-trimmed.wav";
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.bitsPerSample), 2);
+	return writeTrimmedData(wavename, wav_file, start_point, end_point);
+}
 
-		ofs.write(wav_file.subChunk3ID, 4);
 
-		ofs.write(reinterpret_cast<char*>(&wav_file.subChunk3Size), 4);
-		/*Write trimmed data to file*/
-		ofs.write(trimmed_data, wav_file.subChunk3Size);
+// Writes one new wave file per effort.  This function works like
+// writeWaveFile, but takes a vector of trimming point pairs, one pair per
+// effort, ordered in time.  Segment n (counting from 1) is saved as
+// '<name>-trimmed-<n>.wav'.  The raw data is read once and the segments are
+// written out in a single forward pass over it.  Returns the number of
+// segments that could not be written.
+int writeWaveSegments(string fname, waveFileStruct &wav_file,
+	vector<vector<int> > wave_trim_points){
+	string bname = fname.substr(0, fname.size() - 4);
+	int failures = 0;
+	for (unsigned int i = 0; i < wave_trim_points.size(); i++){
+		//each segment gets its own copy of the header info to update
+		waveFileStruct segment = wav_file;
+		int start_point = wave_trim_points[i][0] * 4;
+		int end_point = wave_trim_points[i][1] * 4;
+		string wavename = bname + "-trimmed-" + to_string(i + 1) + ".wav";
+		failures += writeTrimmedData(wavename, segment, start_point, end_point);
 	}
-	//close the stream
-	ofs.close();
-
-	return 0;
+	return failures;
 }
@@ -18,6 +18,7 @@ struct waveFileStruct{
 	short bitsPerSample; //bits per sample
 	char subChunk3ID[5]; //should be 'data' for actual sound data
 	long subChunk3Size;  //size of the data in the file
+	long dataOffset; //byte offset of the sound data within the file
 	vector<short> data; //vector holding the actual data
 	char* raw_data; //vector to hold raw data, this is used for writing back to file
 };
@@ -26,11 +27,35 @@ struct waveFileStruct{
 //chars depending on how the data is to be used
 waveFileStruct readWaveData(string fname, bool initial_read = true, bool debug = false);
 
+//read a whole file into a new[] allocated buffer with a single request,
+//throws an invalid_argument exception if the file cannot be read in full
+char * readWaveFile(string fname, long &size);
+
+//parse a wave file that has already been read into memory, throws an
+//invalid_argument exception if the header or data is truncated
+waveFileStruct parseWaveData(const char * bytes, long size,
+	bool initial_read = true, bool debug = false);
+
 //create the 'amplitude' data from the recorded audio
 vector<char *> constructAmpData(waveFileStruct &, int chunk_size = 1024);
 
+//packs the 44 byte header of a wave file into the passed buffer
+void packWaveHeader(waveFileStruct &, char * header);
+
+//unpacks the 44 byte header at the start of a wave file
+void unpackWaveHeader(const char * header, waveFileStruct &);
+
+//builds the header and trimmed data of a wave file in one new[] allocated
+//buffer, whose size is stored in output_size
+char * packTrimmedWaveFile(waveFileStruct &, int start_point, int end_point,
+	long &output_size);
+
 //writes a wave file given an input waveFileStruct and trim points
 int writeWaveFile(string fname, waveFileStruct &, vector<int> wave_trim_points);
 
+//writes one wave file per pair of trim points
+int writeWaveSegments(string fname, waveFileStruct &,
+	vector<vector<int> > wave_trim_points);
+
 #endif
 
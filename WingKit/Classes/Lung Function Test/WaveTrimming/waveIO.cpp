@@ -0,0 +1,452 @@
+// This source file defines the file I/O backends for the trimming core.  The
+// POSIX backend carries out each request as it is submitted and only queues
+// the completion, retrying reads and writes that are interrupted or return
+// early.  The io_uring backend queues requests in the kernel's submission
+// ring, hands a whole batch to the kernel with a single system call when
+// completions are reaped, and resubmits the remainder of any request that
+// comes back short.
+//
+
+#include <deque>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define WAVEIO_HAS_IO_URING 1
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+
+#include "waveIO.h"
+
+using namespace std;
+
+// Opens a file for reading, or creates/truncates it for writing.
+static int openWaveFile(void * context, const char * fname, bool forWriting){
+	if (forWriting){
+		return open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	return open(fname, O_RDONLY);
+}
+
+// Closes a descriptor returned by openWaveFile.
+static void closeWaveFile(void * context, int fd){
+	close(fd);
+}
+
+/* POSIX backend */
+
+// Carries out a request with positioned reads or writes, retrying calls that
+// are interrupted or transfer fewer bytes than asked for.  Reads stop early
+// only at the end of the file.
+static void performPosixRequest(waveIORequest * request){
+	while (request->transferred < request->nbytes){
+		ssize_t n;
+		if (request->isWrite){
+			n = pwrite(request->fd, request->buffer + request->transferred,
+				request->nbytes - request->transferred,
+				request->offset + request->transferred);
+		}
+		else{
+			n = pread(request->fd, request->buffer + request->transferred,
+				request->nbytes - request->transferred,
+				request->offset + request->transferred);
+		}
+		if (n < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			request->result = -1;
+			return;
+		}
+		if (n == 0){
+			break;
+		}
+		request->transferred += n;
+	}
+	bool shortWrite = request->isWrite && request->transferred < request->nbytes;
+	request->result = shortWrite ? -1 : request->transferred;
+}
+
+// Carries out the request and queues its completion.
+static int posixSubmit(void * context, waveIORequest * request){
+	deque<waveIORequest *> * completions = (deque<waveIORequest *> *) context;
+	request->done = false;
+	request->transferred = 0;
+	performPosixRequest(request);
+	completions->push_back(request);
+	return 0;
+}
+
+// Hands out the queued completions.
+static int posixReap(void * context, waveIORequest ** completed,
+	int maxCompleted){
+	deque<waveIORequest *> * completions = (deque<waveIORequest *> *) context;
+	int count = 0;
+	while (count < maxCompleted && !completions->empty()){
+		completed[count] = completions->front();
+		completed[count]->done = true;
+		completions->pop_front();
+		count++;
+	}
+	return count;
+}
+
+// Releases the completion queue.
+static void posixDestroy(void * context){
+	delete (deque<waveIORequest *> *) context;
+}
+
+// Creates the portable backend built on open/pread/pwrite/close.
+bool createPosixWaveIOBackend(waveIOBackend &backend){
+	backend.context = new deque<waveIORequest *>();
+	backend.openFile = openWaveFile;
+	backend.closeFile = closeWaveFile;
+	backend.submit = posixSubmit;
+	backend.reap = posixReap;
+	backend.destroy = posixDestroy;
+	return true;
+}
+
+/* io_uring backend */
+
+#ifdef WAVEIO_HAS_IO_URING
+
+// State of an io_uring instance: the ring descriptor and pointers into the
+// submission and completion rings shared with the kernel.
+struct ioUringContext{
+	int ringFd;
+	unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+	unsigned *cqHead, *cqTail, *cqMask;
+	io_uring_sqe *sqes;
+	io_uring_cqe *cqes;
+	unsigned sqEntries;
+	void *sqRing, *cqRing;
+	size_t sqRingSize, cqRingSize, sqesSize;
+	unsigned unsubmitted; // entries queued in the ring but not yet entered
+	unsigned inFlight; // requests handed to the kernel and not yet completed
+};
+
+// Hands the queued entries to the kernel, optionally waiting for at least
+// 'minComplete' completions.  Returns 0, or a negative value on failure.
+static int enterIOUring(ioUringContext * ring, unsigned minComplete){
+	unsigned flags = (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0;
+	while (ring->unsubmitted > 0 || minComplete > 0){
+		long n = syscall(__NR_io_uring_enter, ring->ringFd, ring->unsubmitted,
+			minComplete, flags, NULL, 0);
+		if (n < 0){
+			if (errno == EINTR){
+				continue;
+			}
+			return -1;
+		}
+		ring->unsubmitted -= (unsigned) n;
+		ring->inFlight += (unsigned) n;
+		if (ring->unsubmitted == 0){
+			break;
+		}
+	}
+	return 0;
+}
+
+// Queues a submission queue entry for the untransferred part of a request.
+static int queueIOUringEntry(ioUringContext * ring, waveIORequest * request){
+	unsigned tail = *ring->sqTail;
+	if (tail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE) >= ring->sqEntries){
+		//the submission ring is full, hand it to the kernel first
+		if (enterIOUring(ring, 0) != 0){
+			return -1;
+		}
+	}
+	unsigned index = tail & *ring->sqMask;
+	io_uring_sqe * sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = request->isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+	sqe->fd = request->fd;
+	sqe->addr = (unsigned long) (request->buffer + request->transferred);
+	sqe->len = (unsigned) (request->nbytes - request->transferred);
+	sqe->off = request->offset + request->transferred;
+	sqe->user_data = (unsigned long) request;
+	ring->sqArray[index] = index;
+	__atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+	ring->unsubmitted += 1;
+	return 0;
+}
+
+// Queues a request.  Nothing is handed to the kernel until the ring fills up
+// or completions are reaped, so a burst of submissions costs one system call.
+static int ioUringSubmit(void * context, waveIORequest * request){
+	request->done = false;
+	request->transferred = 0;
+	return queueIOUringEntry((ioUringContext *) context, request);
+}
+
+// Hands queued entries to the kernel and collects completions.  A request
+// that comes back short is queued again for its remainder, unless a read hit
+// the end of the file; an interrupted request is retried.  A request whose
+// remainder cannot be queued again completes with a result of -1.
+static int ioUringReap(void * context, waveIORequest ** completed,
+	int maxCompleted){
+	ioUringContext * ring = (ioUringContext *) context;
+	int count = 0;
+	while (count == 0 && (ring->inFlight > 0 || ring->unsubmitted > 0)){
+		unsigned head = *ring->cqHead;
+		unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		if (head == tail){
+			if (enterIOUring(ring, 1) != 0){
+				return -1;
+			}
+			continue;
+		}
+		while (head != tail && count < maxCompleted){
+			io_uring_cqe * cqe = &ring->cqes[head & *ring->cqMask];
+			waveIORequest * request = (waveIORequest *) cqe->user_data;
+			int res = cqe->res;
+			head++;
+			ring->inFlight -= 1;
+			bool finished = true;
+			if (res == -EINTR || res == -EAGAIN){
+				finished = false;
+			}
+			else if (res < 0){
+				request->result = -1;
+			}
+			else{
+				request->transferred += res;
+				bool more = request->transferred < request->nbytes;
+				if (more && res > 0){
+					finished = false;
+				}
+				else if (more && request->isWrite){
+					request->result = -1;
+				}
+				else{
+					request->result = request->transferred;
+				}
+			}
+			if (!finished && queueIOUringEntry(ring, request) != 0){
+				//the remainder could not be queued again, fail the request
+				request->result = -1;
+				finished = true;
+			}
+			if (finished){
+				request->done = true;
+				completed[count++] = request;
+			}
+		}
+		__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+		//requests that have completed are handed back even if entering the
+		//ring fails, the entries still queued are entered on the next reap
+		if (ring->unsubmitted > 0 && enterIOUring(ring, 0) != 0 && count == 0){
+			return -1;
+		}
+	}
+	return count;
+}
+
+// Unmaps the rings and closes the ring descriptor.
+static void ioUringDestroy(void * context){
+	ioUringContext * ring = (ioUringContext *) context;
+	munmap(ring->sqes, ring->sqesSize);
+	if (ring->cqRing != ring->sqRing){
+		munmap(ring->cqRing, ring->cqRingSize);
+	}
+	munmap(ring->sqRing, ring->sqRingSize);
+	close(ring->ringFd);
+	delete ring;
+}
+
+// Creates the io_uring backend.  This sets up a ring and maps its submission
+// and completion queues.  IORING_OP_READ and IORING_OP_WRITE arrived in the
+// same kernel release as IORING_FEAT_RW_CUR_POS, so a kernel without that
+// feature is treated as not supporting io_uring.
+bool createIOUringWaveIOBackend(waveIOBackend &backend, unsigned entries){
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	int ringFd = (int) syscall(__NR_io_uring_setup, entries, &params);
+	if (ringFd < 0){
+		return false;
+	}
+	if (!(params.features & IORING_FEAT_RW_CUR_POS)){
+		close(ringFd);
+		return false;
+	}
+
+	ioUringContext * ring = new ioUringContext();
+	ring->ringFd = ringFd;
+	ring->sqEntries = params.sq_entries;
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMap && ring->cqRingSize > ring->sqRingSize){
+		ring->sqRingSize = ring->cqRingSize;
+	}
+	ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+	if (ring->sqRing == MAP_FAILED){
+		close(ringFd);
+		delete ring;
+		return false;
+	}
+	if (singleMap){
+		ring->cqRing = ring->sqRing;
+	}
+	else{
+		ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+		if (ring->cqRing == MAP_FAILED){
+			munmap(ring->sqRing, ring->sqRingSize);
+			close(ringFd);
+			delete ring;
+			return false;
+		}
+	}
+	ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	ring->sqes = (io_uring_sqe *) mmap(NULL, ring->sqesSize,
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+		IORING_OFF_SQES);
+	if (ring->sqes == MAP_FAILED){
+		if (!singleMap){
+			munmap(ring->cqRing, ring->cqRingSize);
+		}
+		munmap(ring->sqRing, ring->sqRingSize);
+		close(ringFd);
+		delete ring;
+		return false;
+	}
+
+	char * sq = (char *) ring->sqRing;
+	ring->sqHead = (unsigned *) (sq + params.sq_off.head);
+	ring->sqTail = (unsigned *) (sq + params.sq_off.tail);
+	ring->sqMask = (unsigned *) (sq + params.sq_off.ring_mask);
+	ring->sqArray = (unsigned *) (sq + params.sq_off.array);
+	char * cq = (char *) ring->cqRing;
+	ring->cqHead = (unsigned *) (cq + params.cq_off.head);
+	ring->cqTail = (unsigned *) (cq + params.cq_off.tail);
+	ring->cqMask = (unsigned *) (cq + params.cq_off.ring_mask);
+	ring->cqes = (io_uring_cqe *) (cq + params.cq_off.cqes);
+	ring->unsubmitted = 0;
+	ring->inFlight = 0;
+
+	backend.context = ring;
+	backend.openFile = openWaveFile;
+	backend.closeFile = closeWaveFile;
+	backend.submit = ioUringSubmit;
+	backend.reap = ioUringReap;
+	backend.destroy = ioUringDestroy;
+	return true;
+}
+
+#else
+
+// io_uring is only available on Linux.
+bool createIOUringWaveIOBackend(waveIOBackend &backend, unsigned entries){
+	return false;
+}
+
+#endif
+
+/* Backend selection */
+
+// Creates the io_uring backend where available and the POSIX one otherwise.
+void createDefaultWaveIOBackend(waveIOBackend &backend){
+	if (!createIOUringWaveIOBackend(backend)){
+		createPosixWaveIOBackend(backend);
+	}
+}
+
+// Releases a backend created by one of the functions above.
+void destroyWaveIOBackend(waveIOBackend &backend){
+	backend.destroy(backend.context);
+	backend.context = NULL;
+}
+
+// Owns the default backend of a thread, destroying it when the thread exits.
+struct threadWaveIOBackend{
+	waveIOBackend backend;
+	bool created;
+	waveIOBackend * installed;
+	~threadWaveIOBackend(){
+		if (created){
+			destroyWaveIOBackend(backend);
+		}
+	}
+};
+
+static thread_local threadWaveIOBackend threadBackend = {};
+
+// Returns the backend used by the trimming core on the calling thread.
+waveIOBackend & currentWaveIOBackend(){
+	if (threadBackend.installed){
+		return *threadBackend.installed;
+	}
+	if (!threadBackend.created){
+		createDefaultWaveIOBackend(threadBackend.backend);
+		threadBackend.created = true;
+	}
+	return threadBackend.backend;
+}
+
+// Installs a backend for the calling thread, or restores the default.
+void setWaveIOBackend(waveIOBackend * backend){
+	threadBackend.installed = backend;
+}
+
+/* Helpers */
+
+// Returns the size in bytes of an open file, or -1 on failure.
+long waveIOFileSize(int fd){
+	struct stat info;
+	if (fstat(fd, &info) != 0){
+		return -1;
+	}
+	return (long) info.st_size;
+}
+
+// Submits a request and reaps completions until that request is done.  Any
+// other request that completes in the meantime is marked done as well, so
+// callers mixing these helpers with their own queued requests should check
+// the requests' 'done' flags rather than rely on reap alone.
+static long waitForRequest(waveIOBackend &backend, waveIORequest &request){
+	if (backend.submit(backend.context, &request) != 0){
+		return -1;
+	}
+	waveIORequest * completed[8];
+	while (!request.done){
+		if (backend.reap(backend.context, completed, 8) <= 0){
+			return -1;
+		}
+	}
+	return request.result;
+}
+
+// Reads nbytes at offset and waits for the read to complete.
+long waveIORead(waveIOBackend &backend, int fd, char * buffer, long nbytes,
+	long offset){
+	waveIORequest request = {};
+	request.fd = fd;
+	request.buffer = buffer;
+	request.nbytes = nbytes;
+	request.offset = offset;
+	request.isWrite = false;
+	return waitForRequest(backend, request);
+}
+
+// Writes nbytes at offset and waits for the write to complete.
+long waveIOWrite(waveIOBackend &backend, int fd, const char * buffer,
+	long nbytes, long offset){
+	waveIORequest request = {};
+	request.fd = fd;
+	request.buffer = (char *) buffer;
+	request.nbytes = nbytes;
+	request.offset = offset;
+	request.isWrite = true;
+	return waitForRequest(backend, request);
+}
@@ -0,0 +1,82 @@
+// This header file declares the file I/O backend used by the trimming core.
+// Reading and writing wave files goes through a small table of functions so
+// that a platform specific implementation can be swapped in without touching
+// the parsing and trimming logic.  Reads and writes are queued on the backend
+// and their completions reaped later, which lets a caller keep many files in
+// flight at once.  On Linux the backend is built on io_uring, elsewhere (or if
+// io_uring is unavailable) it falls back to positioned POSIX reads and writes.
+//
+
+#ifndef WAVEIO_H
+#define WAVEIO_H
+
+// A single read or write queued on an I/O backend.  The buffer must stay valid
+// and the request must not move in memory until the request has completed.
+struct waveIORequest{
+	int fd; // file descriptor returned by the backend's openFile
+	char * buffer; // data to write, or room for the data to read
+	long nbytes; // number of bytes to transfer
+	long offset; // byte offset in the file
+	bool isWrite; // true for a write, false for a read
+	void * userData; // free for the caller, e.g. to find its file on completion
+	long result; // bytes transferred, or -1 on failure, set on completion
+	bool done; // set once the request has completed
+	long transferred; // bytes transferred so far, maintained by the backend
+};
+
+// Table of the file operations needed by the trimming core.  Every function
+// takes the backend's context as its first argument.
+//  - openFile returns a descriptor, or a negative value on failure.
+//  - submit queues a request and returns 0, or a negative value on failure.
+//    Reads only come back short at the end of the file, writes either
+//    transfer every byte or fail.
+//  - reap waits until at least one queued request has completed, stores up to
+//    maxCompleted completed requests in 'completed', marks them done and
+//    returns how many were stored.  It returns 0 if nothing is queued.
+//  - destroy releases the context.
+struct waveIOBackend{
+	void * context;
+	int (*openFile)(void * context, const char * fname, bool forWriting);
+	void (*closeFile)(void * context, int fd);
+	int (*submit)(void * context, waveIORequest * request);
+	int (*reap)(void * context, waveIORequest ** completed, int maxCompleted);
+	void (*destroy)(void * context);
+};
+
+// Creates the portable backend built on open/pread/pwrite/close.  Requests
+// are carried out as they are submitted.
+bool createPosixWaveIOBackend(waveIOBackend &backend);
+
+// Creates the io_uring backend with a submission queue of 'entries' requests.
+// Returns false if io_uring is not available on this platform or kernel.
+bool createIOUringWaveIOBackend(waveIOBackend &backend, unsigned entries = 64);
+
+// Creates the io_uring backend where available and the POSIX one otherwise.
+void createDefaultWaveIOBackend(waveIOBackend &backend);
+
+// Releases a backend created by one of the functions above.
+void destroyWaveIOBackend(waveIOBackend &backend);
+
+// Returns the backend used by the trimming core on the calling thread.  Each
+// thread lazily creates its own default backend, so backends are never shared
+// between threads.
+waveIOBackend & currentWaveIOBackend();
+
+// Installs a backend for the calling thread, or restores the thread's default
+// backend when passed NULL.  The caller keeps ownership of the backend.
+void setWaveIOBackend(waveIOBackend * backend);
+
+// Returns the size in bytes of an open file, or -1 on failure.
+long waveIOFileSize(int fd);
+
+// Reads nbytes at offset and waits for the read to complete.  Returns the
+// number of bytes read, or -1 on failure.
+long waveIORead(waveIOBackend &backend, int fd, char * buffer, long nbytes,
+	long offset);
+
+// Writes nbytes at offset and waits for the write to complete.  Returns the
+// number of bytes written, or -1 on failure.
+long waveIOWrite(waveIOBackend &backend, int fd, const char * buffer,
+	long nbytes, long offset);
+
+#endif
@@ -22,11 +22,15 @@
 #include <string>
 #include <sstream>
 #include <math.h>
+#include <algorithm>
 
 
 #include "amparray.h"
 #include "trimmingTerminalPoints.h"
 #include "wavdata.h"
+#include "noiseFloor.h"
+#include "waveIO.h"
+#include "waveTrimming.h"
 
 using namespace std;
 
@@ -37,9 +41,11 @@ using namespace std;
 // index of  the trimming points (the first timewise trimming point) is
 // calculated from the amplitude data.  This point is then rescaled up to the
 // size of the original sound data.  The same operations are performed to
-// determine the 'end' point of the trimming.  These points are then pushed
-// onto a vector and the vector is returned.
-vector<int> getTrimmingPoints(vector<char*> ampData, int threshold = 100) {
+// determine the 'end' point of the trimming, where the effort is over once
+// the data falls beneath 'silencePercent' of the maximum.  These points are
+// then pushed onto a vector and the vector is returned.
+vector<int> getTrimmingPoints(vector<char*> ampData, int threshold,
+                              double silencePercent) {
 	int chunkSize = 1024;
 	vector<int> trimmingPoints;
 	vector<char *> smoothedAmpData = smoothAmpData(ampData, threshold);
@@ -50,7 +56,8 @@ vector<int> getTrimmingPoints(vector<char*> ampData, int threshold = 100) {
 	int sndStartPt = determineSndStartPoint(startIndex, smoothedAmpData,
                                             chunkSize);
 
-	int endIndex = determineEndIndex(smoothedAmpData, maxAmpInd);
+	int endIndex = determineEndIndex(smoothedAmpData, maxAmpInd,
+                                     silencePercent);
 	int sndEndPt = determineSndEndPoint(endIndex, smoothedAmpData, chunkSize);
 
 	trimmingPoints.push_back(sndStartPt);
@@ -58,20 +65,289 @@ vector<int> getTrimmingPoints(vector<char*> ampData, int threshold = 100) {
 	return trimmingPoints;
 }
 
+// Outlines the process for a recording holding several efforts.  This works
+// like getTrimmingPoints, but instead of a single start and end point around
+// the global maximum, every effort found by determineEffortRanges is rescaled
+// and padded.  A padded start point is never moved before the padded end
+// point of the previous effort, so the returned pairs do not overlap.  An
+// effort left empty by that, i.e. one lying wholly within the padding of the
+// previous effort, is already part of the previous pair and is dropped.
+vector<vector<int> > getEffortTrimmingPoints(vector<char*> ampData,
+                                             int threshold,
+                                             double silencePercent) {
+	int chunkSize = 1024;
+	vector<vector<int> > trimmingPoints;
+	vector<char *> smoothedAmpData = smoothAmpData(ampData, threshold);
+
+	vector<effortRange> efforts = determineEffortRanges(smoothedAmpData,
+                                                        silencePercent);
+
+	int prevSndEndPt = 0;
+	for (unsigned int i = 0; i < efforts.size(); i++){
+		int sndStartPt = determineSndStartPoint(efforts[i].startInd,
+                                                smoothedAmpData, chunkSize);
+		int sndEndPt = determineSndEndPoint(efforts[i].endInd,
+                                            smoothedAmpData, chunkSize);
+		sndStartPt = max(sndStartPt, prevSndEndPt);
+		if (sndStartPt >= sndEndPt){
+			continue;
+		}
+
+		vector<int> points;
+		points.push_back(sndStartPt);
+		points.push_back(sndEndPt);
+		trimmingPoints.push_back(points);
+		prevSndEndPt = sndEndPt;
+	}
+	return trimmingPoints;
+}
+
 // Main function of the program.  First parses the arguments passed to the
 // program.  Creates an array of amplitude data read from a specified file, then
 // passes this amplitude data to the function that calls the processing cascade.
+// The smoothing threshold and the level at which the effort is considered
+// over are both derived from the noise floor of the recording, which is
+// reported through 'noiseFloor'.
+int trim(string inputFileName, string outputFileName, double &noiseFloor) {
+	//the file is read once, then parsed as samples for the analysis and as
+	//raw bytes for writing the trimmed file
+	long size;
+	char * bytes;
+	waveFileStruct waveFile;
+	waveFileStruct toBeTrimmed;
+	try {
+		bytes = readWaveFile(inputFileName, size);
+	}
+	catch (const invalid_argument& e) {
+		return 1;
+	}
+	try {
+		waveFile = parseWaveData(bytes, size, true, true);
+		toBeTrimmed = parseWaveData(bytes, size, false);
+	}
+	catch (const invalid_argument& e) {
+		delete[] bytes;
+		return 1;
+	}
+	delete[] bytes;
+	vector<char*> rawAmpData = constructAmpData(waveFile);
+	noiseFloorEstimate noise = estimateNoiseFloor(rawAmpData);
+	noiseFloor = noise.level;
+	vector <int> soundTrimmingPoints = getTrimmingPoints(rawAmpData,
+                                                         noise.threshold,
+                                                         noise.silencePercent);
+	int result = writeWaveFile(outputFileName, toBeTrimmed,
+                               soundTrimmingPoints);
+	delete[] toBeTrimmed.raw_data;
+	return result;
+}
+
+// Trims a recording, discarding the estimated noise floor.
 int trim(string inputFileName, string outputFileName) {
+	double noiseFloor;
+	return trim(inputFileName, outputFileName, noiseFloor);
+}
+
+// Trims every effort of a recording.  The input file is read once, analysed
+// to find all efforts, and each effort is then written to its own trimmed
+// wave file in a single forward pass over the same bytes.  The number of
+// files written is reported through 'effortCount'.  Like trim(), returns 0
+// on success, i.e. when every effort found was written (a recording holding
+// no efforts writes nothing), and 1 if the input file could not be read or a
+// segment could not be written.
+int trimEfforts(string inputFileName, string outputFileName, int &effortCount) {
+	effortCount = 0;
+	long size;
+	char * bytes;
 	waveFileStruct waveFile;
 	try {
-		waveFile = readWaveData(inputFileName, true, true);
+		bytes = readWaveFile(inputFileName, size);
 	}
 	catch (const invalid_argument& e) {
 		return 1;
 	}
+	try {
+		waveFile = parseWaveData(bytes, size, true);
+	}
+	catch (const invalid_argument& e) {
+		delete[] bytes;
+		return 1;
+	}
+	vector<char*> rawAmpData = constructAmpData(waveFile);
+	noiseFloorEstimate noise = estimateNoiseFloor(rawAmpData);
+	vector<vector<int> > soundTrimmingPoints =
+		getEffortTrimmingPoints(rawAmpData, noise.threshold,
+                                noise.silencePercent);
+	if (soundTrimmingPoints.empty()) {
+		delete[] bytes;
+		return 0;
+	}
+	//the bytes already parsed once are parsed again as raw data, this cannot
+	//fail since the same bytes parsed as samples
+	waveFileStruct toBeTrimmed = parseWaveData(bytes, size, false);
+	delete[] bytes;
+	int failures = writeWaveSegments(outputFileName, toBeTrimmed,
+                                     soundTrimmingPoints);
+	delete[] toBeTrimmed.raw_data;
+	effortCount = (int) soundTrimmingPoints.size() - failures;
+	return (failures == 0) ? 0 : 1;
+}
+
+// Trims every effort of a recording, discarding the number of efforts.
+int trimEfforts(string inputFileName, string outputFileName) {
+	int effortCount;
+	return trimEfforts(inputFileName, outputFileName, effortCount);
+}
+
+
+// State of one file handled by trimFiles.  The request is handed to the I/O
+// backend, so the state must not move while a read or write is in flight.
+struct batchTrimFile{
+	string inputFileName;
+	int fd; // descriptor of the file currently being read or written
+	char * bytes; // whole input file, then the whole trimmed output file
+	long size; // number of bytes in 'bytes'
+	waveIORequest request;
+};
+
+// Queues a whole file read or write of file.bytes on the backend.  Returns
+// false if the request could not be queued.
+static bool submitBatchTrimRequest(waveIOBackend &io, batchTrimFile &file,
+                                   bool isWrite) {
+	file.request.fd = file.fd;
+	file.request.buffer = file.bytes;
+	file.request.nbytes = file.size;
+	file.request.offset = 0;
+	file.request.isWrite = isWrite;
+	file.request.userData = &file;
+	file.request.result = -1;
+	file.request.done = false;
+	file.request.transferred = 0;
+	return io.submit(io.context, &file.request) == 0;
+}
+
+// Opens an input file and queues a read of the whole file.  Returns false if
+// the file could not be opened or the read could not be queued.
+static bool startBatchTrimRead(waveIOBackend &io, batchTrimFile &file) {
+	file.fd = io.openFile(io.context, file.inputFileName.c_str(), false);
+	if (file.fd < 0) {
+		return false;
+	}
+	file.size = waveIOFileSize(file.fd);
+	if (file.size < 0) {
+		io.closeFile(io.context, file.fd);
+		return false;
+	}
+	file.bytes = new char[file.size];
+	if (!submitBatchTrimRequest(io, file, false)) {
+		io.closeFile(io.context, file.fd);
+		delete[] file.bytes;
+		return false;
+	}
+	return true;
+}
+
+// Trims an input file that has been read into memory, the same way trim()
+// does, and queues a write of the trimmed file.  The input bytes are replaced
+// by the trimmed output file.  Returns false if the input is not a valid wave
+// file or the trimmed file could not be opened or queued.
+static bool startBatchTrimWrite(waveIOBackend &io, batchTrimFile &file) {
+	waveFileStruct waveFile;
+	waveFileStruct toBeTrimmed;
+	try {
+		waveFile = parseWaveData(file.bytes, file.size, true);
+		toBeTrimmed = parseWaveData(file.bytes, file.size, false);
+	}
+	catch (const invalid_argument& e) {
+		delete[] file.bytes;
+		return false;
+	}
+	delete[] file.bytes;
 	vector<char*> rawAmpData = constructAmpData(waveFile);
-	vector <int> soundTrimmingPoints = getTrimmingPoints(rawAmpData);
-	waveFileStruct toBeTrimmed = readWaveData(inputFileName, false);
-	writeWaveFile(outputFileName, toBeTrimmed, soundTrimmingPoints);
-	return 0;
+	noiseFloorEstimate noise = estimateNoiseFloor(rawAmpData);
+	vector<int> soundTrimmingPoints = getTrimmingPoints(rawAmpData,
+                                                        noise.threshold,
+                                                        noise.silencePercent);
+	file.bytes = packTrimmedWaveFile(toBeTrimmed, soundTrimmingPoints[0] * 4,
+                                     soundTrimmingPoints[1] * 4, file.size);
+	delete[] toBeTrimmed.raw_data;
+
+	string outputFileName = file.inputFileName.substr(0,
+		file.inputFileName.size() - 4) + "-trimmed.wav";
+	file.fd = io.openFile(io.context, outputFileName.c_str(), true);
+	if (file.fd < 0) {
+		delete[] file.bytes;
+		return false;
+	}
+	if (!submitBatchTrimRequest(io, file, true)) {
+		io.closeFile(io.context, file.fd);
+		delete[] file.bytes;
+		return false;
+	}
+	return true;
+}
+
+// Trims a batch of recordings, saving each one next to its input as
+// '<name>-trimmed.wav' like trim() does.  Rather than reading, trimming and
+// writing the files one after another, up to maxInFlight files are kept in
+// flight on the calling thread's I/O backend: whole file reads and writes are
+// queued and, as each completes, the file moves on to trimming or is done.
+// With the io_uring backend the queued requests reach the kernel together, so
+// reading one file overlaps with trimming and writing the others.  Returns
+// the number of files that could not be trimmed.
+int trimFiles(vector<string> inputFileNames, int maxInFlight) {
+	waveIOBackend &io = currentWaveIOBackend();
+	maxInFlight = max(maxInFlight, 1);
+	//the state of every file is allocated up front so that the queued
+	//requests never move
+	vector<batchTrimFile> files(inputFileNames.size());
+	int failures = 0;
+	int inFlight = 0;
+	unsigned int next = 0;
+	while (next < files.size() || inFlight > 0) {
+		while (inFlight < maxInFlight && next < files.size()) {
+			files[next].inputFileName = inputFileNames[next];
+			if (startBatchTrimRead(io, files[next])) {
+				inFlight++;
+			}
+			else {
+				failures++;
+			}
+			next++;
+		}
+		if (inFlight == 0) {
+			continue;
+		}
+
+		waveIORequest * completed[16];
+		int count = io.reap(io.context, completed, 16);
+		if (count <= 0) {
+			//the backend failed, buffers still queued on it cannot be
+			//released safely, so give up on every unfinished file
+			return failures + inFlight + (int) (files.size() - next);
+		}
+		for (int i = 0; i < count; i++) {
+			batchTrimFile &file = *(batchTrimFile *) completed[i]->userData;
+			io.closeFile(io.context, file.fd);
+			bool complete = completed[i]->result == file.size;
+			if (completed[i]->isWrite) {
+				//the trimmed file is written, this file is done
+				delete[] file.bytes;
+				if (!complete) {
+					failures++;
+				}
+				inFlight--;
+			}
+			else if (!complete) {
+				delete[] file.bytes;
+				failures++;
+				inFlight--;
+			}
+			else if (!startBatchTrimWrite(io, file)) {
+				failures++;
+				inFlight--;
+			}
+		}
+	}
+	return failures;
 }
@@ -10,9 +10,25 @@
 #define waveTrimming_h
 
 #include <string>
+#include <vector>
 
 using namespace std;
 
+vector<int> getTrimmingPoints(vector<char*> ampData, int threshold = 100,
+                              double silencePercent = 0.1);
+
+vector<vector<int> > getEffortTrimmingPoints(vector<char*> ampData,
+                                             int threshold = 100,
+                                             double silencePercent = 0.1);
+
 int trim(string inputFileName, string outputFileName);
 
+int trim(string inputFileName, string outputFileName, double &noiseFloor);
+
+int trimEfforts(string inputFileName, string outputFileName);
+
+int trimEfforts(string inputFileName, string outputFileName, int &effortCount);
+
+int trimFiles(vector<string> inputFileNames, int maxInFlight = 8);
+
 #endif /* waveTrimming_h */
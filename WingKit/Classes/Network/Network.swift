@@ -53,6 +53,8 @@ internal protocol NetworkProtocol {
     func send(request: URLRequestConvertible, completion: @escaping (JSON?, Error?) -> Void)
     func uploadFile(atFilepath filepath: String, toBucket bucket: String,
                     withKey key: String, completion: @escaping (Error?) -> Void)
+    func uploadStream(from producer: TrimmedWaveProducer, toBucket bucket: String,
+                      withKey key: String, completion: @escaping (Error?) -> Void)
 }
 
 internal class Network: NetworkProtocol {
@@ -63,6 +65,7 @@ internal class Network: NetworkProtocol {
     fileprivate let identityPoolId = "us-east-1:af3df912-5e61-40dc-9c5e-651f7e0b3789"
     fileprivate let cognitoRegion = AWSRegionType.USEast1
     fileprivate let bucketRegion = AWSRegionType.USEast1
+    fileprivate let uploadChunkSize = 64 * 1024
 
     internal init() {
 
@@ -100,7 +103,7 @@ internal class Network: NetworkProtocol {
                 let statusCodes = (request as? NetworkRequest)?.acceptableStatusCodes ?? self.defaultAcceptableStatusCodes
 
                 do {
-                    try self.validateResponse(response, acceptableStatusCodes: statusCodes)
+                    try Network.validateResponse(response, acceptableStatusCodes: statusCodes)
 
                     guard let data = data,
                         let json = try JSONSerialization.jsonObject(with: data, options: []) as? JSON else {
@@ -138,7 +141,121 @@ internal class Network: NetworkProtocol {
         }
     }
 
-    fileprivate func validateResponse(_ response: URLResponse, acceptableStatusCodes: [Int]) throws {
+    internal func uploadStream(from producer: TrimmedWaveProducer, toBucket bucket: String,
+                               withKey key: String, completion: @escaping (Error?) -> Void) {
+
+        let presignedURLRequest = AWSS3GetPreSignedURLRequest()
+        presignedURLRequest.bucket = bucket
+        presignedURLRequest.key = key
+        presignedURLRequest.httpMethod = .PUT
+        presignedURLRequest.expires = Date(timeIntervalSinceNow: 3600)
+        presignedURLRequest.contentType = "audio/x-wav"
+
+        AWSS3PreSignedURLBuilder.default().getPreSignedURL(presignedURLRequest).continueWith { task in
+
+            guard let url = task.result as URL? else {
+                DispatchQueue.main.async { completion(task.error ?? NetworkError.invalidResponse) }
+                return nil
+            }
+
+            Network.uploadStream(from: producer, to: url, using: URLSession.shared,
+                                 chunkSize: self.uploadChunkSize, completion: completion)
+
+            return nil
+        }
+    }
+
+    /**
+     Streams the trimmed recording of a producer to a URL with a PUT request. The body is pumped from the producer
+     through a pair of bound streams, so the trimmed recording is never held in memory or written to disk as a whole.
+
+     - Parameters:
+        - producer: The producer of the trimmed recording.
+        - url: The URL to upload the trimmed recording to, e.g. a presigned S3 URL.
+        - session: The session to send the request with.
+        - chunkSize: The size of the chunks pulled from the producer.
+        - completion: Called on the main queue with the producer's error, the request's error or `nil` on success.
+     */
+    internal static func uploadStream(from producer: TrimmedWaveProducer, to url: URL, using session: URLSession,
+                                      chunkSize: Int, completion: @escaping (Error?) -> Void) {
+
+        let expectedLength = producer.expectedLength()
+        guard expectedLength >= 0 else {
+            let error = NSError(domain: TrimmedWaveProducerErrorDomain,
+                                code: TrimmedWaveProducerError.openFailed.rawValue, userInfo: nil)
+            DispatchQueue.main.async { completion(error) }
+            return
+        }
+
+        var inputStream: InputStream?
+        var outputStream: OutputStream?
+        Stream.getBoundStreams(withBufferSize: chunkSize, inputStream: &inputStream, outputStream: &outputStream)
+
+        guard let bodyStream = inputStream, let pumpStream = outputStream else {
+            DispatchQueue.main.async { completion(NetworkError.invalidResponse) }
+            return
+        }
+
+        var request = URLRequest(url: url)
+        request.httpMethod = HTTPMethod.put.rawValue
+        request.setValue("audio/x-wav", forHTTPHeaderField: "Content-Type")
+        request.setValue(String(expectedLength), forHTTPHeaderField: "Content-Length")
+        request.httpBodyStream = bodyStream
+
+        // The pump and the request complete on different queues, so the pump's error is handed over on a
+        // serial queue.
+        let producerErrorQueue = DispatchQueue(label: "com.sparolabs.WingKit.uploadStream")
+        var producerError: Error?
+
+        DispatchQueue.global(qos: .utility).async {
+            pumpStream.open()
+            defer { pumpStream.close() }
+
+            do {
+                while true {
+                    let chunk = try producer.nextChunk(withMaxLength: UInt(chunkSize))
+                    if chunk.isEmpty { break }
+
+                    try chunk.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) -> Void in
+                        var offset = 0
+                        while offset < chunk.count {
+                            let written = pumpStream.write(bytes + offset, maxLength: chunk.count - offset)
+                            guard written > 0 else {
+                                throw pumpStream.streamError ?? NetworkError.invalidResponse
+                            }
+                            offset += written
+                        }
+                    }
+                }
+            } catch {
+                producerErrorQueue.sync { producerError = error }
+            }
+        }
+
+        let uploadTask = session.dataTask(with: request, completionHandler: { (_, response, error) in
+
+            if let error = producerErrorQueue.sync(execute: { producerError }) ?? error {
+                DispatchQueue.main.async { completion(error) }
+                return
+            }
+
+            guard let response = response else {
+                DispatchQueue.main.async { completion(NetworkError.invalidResponse) }
+                return
+            }
+
+            do {
+                try Network.validateResponse(response, acceptableStatusCodes: Array(200..<300))
+                DispatchQueue.main.async { completion(nil) }
+            } catch {
+                DispatchQueue.main.async { completion(error) }
+            }
+        })
+
+        uploadTask.resume()
+    }
+
+    fileprivate static func validateResponse(_ response: URLResponse, acceptableStatusCodes: [Int]) throws {
         guard let response = response as? HTTPURLResponse else {
             throw NetworkError.invalidResponse
         }
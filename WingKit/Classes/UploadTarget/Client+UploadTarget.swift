@@ -77,4 +77,11 @@ extension Client {
                                   withKey: uploadTarget.key, completion: completion)
     }
 
+    internal func uploadStream(from producer: TrimmedWaveProducer,
+                               to uploadTarget: UploadTarget, completion: @escaping (Error?) -> Void) {
+
+        Network.shared.uploadStream(from: producer, toBucket: uploadTarget.bucket,
+                                    withKey: uploadTarget.key, completion: completion)
+    }
+
 }
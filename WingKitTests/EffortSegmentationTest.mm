@@ -0,0 +1,133 @@
+//
+//  EffortSegmentationTest.mm
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <string>
+#include <vector>
+
+#include "TrimmingTestHelpers.h"
+#include "amparray.h"
+#include "waveTrimming.h"
+
+@interface EffortSegmentationTest : XCTestCase
+@end
+
+@implementation EffortSegmentationTest
+
+- (void)testFindsEveryEffort {
+    vector<char *> ampData = makeAmpData(600, 0);
+    setAmpData(ampData, 50, 80, 9000);
+    setAmpData(ampData, 200, 260, 15000);
+    setAmpData(ampData, 400, 480, 12000);
+
+    vector<effortRange> efforts = determineEffortRanges(ampData);
+
+    XCTAssertEqual(efforts.size(), 3u);
+    freeAmpData(ampData);
+}
+
+- (void)testEffortsDoNotOverlapOrReachIntoPrecedingSilence {
+    // blows at samples 100000-200000 and 400000-500000
+    vector<char *> ampData = makeAmpData(600, 0);
+    setAmpData(ampData, 98, 196, 15000);
+    setAmpData(ampData, 391, 489, 15000);
+
+    vector<effortRange> efforts = determineEffortRanges(ampData);
+
+    XCTAssertEqual(efforts.size(), 2u);
+    if (efforts.size() != 2) {
+        freeAmpData(ampData);
+        return;
+    }
+    XCTAssertEqual(efforts[0].startInd, 98);
+    XCTAssertEqual(efforts[1].startInd, 391);
+    XCTAssertLessThan(efforts[0].endInd, efforts[1].startInd);
+    XCTAssertLessThan(efforts[1].startInd, efforts[1].endInd);
+    freeAmpData(ampData);
+}
+
+- (void)testStartStopsAtLocalMinimumWithinEffort {
+    vector<char *> ampData = makeAmpData(300, 0);
+    setAmpData(ampData, 100, 110, 8000);
+    setAmpData(ampData, 110, 111, 2000);
+    setAmpData(ampData, 111, 150, 15000);
+
+    vector<effortRange> efforts = determineEffortRanges(ampData);
+
+    XCTAssertEqual(efforts.size(), 1u);
+    if (efforts.size() == 1) {
+        XCTAssertEqual(efforts[0].startInd, 110);
+    }
+    freeAmpData(ampData);
+}
+
+- (void)testDropsEffortsBeneathMinPeakPercent {
+    vector<char *> ampData = makeAmpData(600, 0);
+    setAmpData(ampData, 100, 200, 15000);
+    setAmpData(ampData, 400, 450, 3000);
+
+    XCTAssertEqual(determineEffortRanges(ampData).size(), 1u);
+    XCTAssertEqual(determineEffortRanges(ampData, 0.1, 10, 0.1).size(), 2u);
+    freeAmpData(ampData);
+}
+
+- (void)testEffortStillOpenAtEndOfDataEndsAtLastPoint {
+    vector<char *> ampData = makeAmpData(600, 0);
+    setAmpData(ampData, 100, 200, 15000);
+    setAmpData(ampData, 500, 600, 15000);
+
+    vector<effortRange> efforts = determineEffortRanges(ampData);
+
+    XCTAssertEqual(efforts.size(), 2u);
+    if (efforts.size() == 2) {
+        XCTAssertEqual(efforts[1].startInd, 500);
+        XCTAssertEqual(efforts[1].endInd, 599);
+    }
+    freeAmpData(ampData);
+}
+
+- (void)testEmptyAmpDataHasNoEfforts {
+    vector<char *> ampData;
+
+    XCTAssertEqual(determineEffortRanges(ampData).size(), 0u);
+}
+
+- (void)testEffortTrimmingPointsDoNotOverlap {
+    vector<char *> ampData = makeAmpData(600, 30);
+    setAmpData(ampData, 98, 196, 15000);
+    setAmpData(ampData, 210, 235, 15000);
+    setAmpData(ampData, 391, 489, 15000);
+
+    vector<vector<int> > points = getEffortTrimmingPoints(ampData);
+
+    XCTAssertEqual(points.size(), 3u);
+    for (unsigned int i = 0; i < points.size(); i++) {
+        XCTAssertLessThan(points[i][0], points[i][1]);
+        if (i > 0) {
+            XCTAssertLessThanOrEqual(points[i - 1][1], points[i][0]);
+        }
+    }
+    freeAmpData(ampData);
+}
+
+- (void)testEffortWithinPaddingOfPreviousEffortIsDropped {
+    // the second effort lies wholly within the end padding of the first
+    vector<char *> ampData = makeAmpData(300, 30);
+    setAmpData(ampData, 100, 289, 15000);
+    setAmpData(ampData, 299, 300, 15000);
+
+    vector<vector<int> > points = getEffortTrimmingPoints(ampData);
+
+    XCTAssertEqual(points.size(), 1u);
+    if (points.size() == 1) {
+        XCTAssertEqual(points[0][1], 300 * 1024);
+    }
+    freeAmpData(ampData);
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  LocalHTTPListener.swift
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+import Foundation
+
+/// A stand-in HTTP server on the loopback interface. It accepts a single connection, records the request it
+/// receives and answers it with a fixed status code.
+class LocalHTTPListener {
+
+    /// A request received by the listener.
+    struct Request {
+        let method: String
+        let headers: [String: String]
+        let body: Data
+    }
+
+    /// The URL the listener accepts requests on.
+    let url: URL
+
+    fileprivate let socketDescriptor: Int32
+    fileprivate let statusCode: Int
+    fileprivate let received = DispatchSemaphore(value: 0)
+    fileprivate var request: Request?
+
+    /**
+     Starts listening on an ephemeral port.
+
+     - Parameter statusCode: The status code to answer the request with.
+     */
+    init?(statusCode: Int = 200) {
+
+        socketDescriptor = socket(AF_INET, SOCK_STREAM, 0)
+        guard socketDescriptor >= 0 else { return nil }
+
+        var address = sockaddr_in()
+        address.sin_len = UInt8(MemoryLayout<sockaddr_in>.size)
+        address.sin_family = sa_family_t(AF_INET)
+        address.sin_port = 0
+        address.sin_addr.s_addr = inet_addr("127.0.0.1")
+
+        var length = socklen_t(MemoryLayout<sockaddr_in>.size)
+        let descriptor = socketDescriptor
+        let listening = withUnsafeMutablePointer(to: &address) { pointer -> Bool in
+            return pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) { address in
+                return bind(descriptor, address, length) == 0
+                    && listen(descriptor, 1) == 0
+                    && getsockname(descriptor, address, &length) == 0
+            }
+        }
+        guard listening else {
+            close(socketDescriptor)
+            return nil
+        }
+
+        url = URL(string: "http://127.0.0.1:\(UInt16(bigEndian: address.sin_port))/upload")!
+        self.statusCode = statusCode
+
+        DispatchQueue.global(qos: .utility).async { self.serve() }
+    }
+
+    deinit {
+        close(socketDescriptor)
+    }
+
+    /// Waits for the request to be received and returns it, or `nil` if none arrived in time.
+    func waitForRequest(timeout: TimeInterval = 10) -> Request? {
+        guard received.wait(timeout: .now() + timeout) == .success else { return nil }
+        return request
+    }
+
+    fileprivate func serve() {
+
+        // give up after a while so a listener that is never connected to does not block a thread forever
+        var descriptor = pollfd(fd: socketDescriptor, events: Int16(POLLIN), revents: 0)
+        guard poll(&descriptor, 1, 10000) > 0 else {
+            received.signal()
+            return
+        }
+
+        let connection = accept(socketDescriptor, nil, nil)
+        guard connection >= 0 else {
+            received.signal()
+            return
+        }
+        defer { close(connection) }
+
+        let separator = "\r\n\r\n".data(using: .utf8)!
+        var data = Data()
+        var buffer = [UInt8](repeating: 0, count: 64 * 1024)
+        var head: (method: String, headers: [String: String], bodyStart: Int)?
+
+        while true {
+            if head == nil, let range = data.range(of: separator) {
+                let lines = String(data: data.subdata(in: 0..<range.lowerBound), encoding: .utf8)?
+                    .components(separatedBy: "\r\n") ?? []
+                var headers = [String: String]()
+                for line in lines.dropFirst() {
+                    guard let colon = line.index(of: ":") else { continue }
+                    let name = String(line[..<colon]).lowercased()
+                    headers[name] = String(line[line.index(after: colon)...]).trimmingCharacters(in: .whitespaces)
+                }
+                let method = lines.first?.components(separatedBy: " ").first ?? ""
+                head = (method, headers, range.upperBound)
+            }
+
+            if let head = head {
+                let contentLength = Int(head.headers["content-length"] ?? "") ?? 0
+                if data.count - head.bodyStart >= contentLength { break }
+            }
+
+            let count = read(connection, &buffer, buffer.count)
+            if count <= 0 { break }
+            data.append(buffer, count: count)
+        }
+
+        if let head = head {
+            request = Request(method: head.method, headers: head.headers,
+                              body: data.subdata(in: head.bodyStart..<data.count))
+        }
+
+        let response = "HTTP/1.1 \(statusCode) Status\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"
+        _ = response.withCString { write(connection, $0, strlen($0)) }
+
+        received.signal()
+    }
+}
@@ -21,4 +21,11 @@ class NetworkMock: NetworkProtocol {
                     withKey key: String, completion: @escaping (Error?) -> Void) {
         uploadFileStub?(filepath, bucket, key, completion)
     }
+
+    var uploadStreamStub: ((_ producer: TrimmedWaveProducer, _ bucket: String, _ key: String,
+        _ completion: (Error?) -> Void) -> Void)?
+    func uploadStream(from producer: TrimmedWaveProducer, toBucket bucket: String,
+                      withKey key: String, completion: @escaping (Error?) -> Void) {
+        uploadStreamStub?(producer, bucket, key, completion)
+    }
 }
@@ -0,0 +1,133 @@
+//
+//  NoiseFloorTest.mm
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "TrimmingTestHelpers.h"
+#include "noiseFloor.h"
+#include "waveTrimming.h"
+
+@interface NoiseFloorTest : XCTestCase
+@end
+
+@implementation NoiseFloorTest
+
+- (void)testExactQuantileMatchesSortedValues {
+    int sizes[] = {1, 2, 5, 100, 1001};
+    double quantiles[] = {0, 0.1, 0.25, 0.5, 0.9, 1};
+    unsigned int seed = 7;
+    for (int size : sizes) {
+        std::vector<int> values(size);
+        for (int i = 0; i < size; i++) {
+            seed = seed * 1664525 + 1013904223;
+            values[i] = (int) ((seed >> 16) % 20000);
+        }
+        std::vector<int> sorted(values);
+        std::sort(sorted.begin(), sorted.end());
+
+        for (double p : quantiles) {
+            std::vector<int> copy(values);
+            XCTAssertEqual(exactQuantile(copy, p), sorted[(int) (p * (size - 1))]);
+        }
+    }
+
+    std::vector<int> empty;
+    XCTAssertEqual(exactQuantile(empty, 0.25), 0);
+}
+
+- (void)testLevelOfShortRecordingIsExact {
+    std::vector<char *> ampData = makeAmpData(100, 30);
+    setAmpData(ampData, 60, 100, 15000);
+
+    XCTAssertEqual(estimateNoiseFloor(ampData).level, 30);
+    freeAmpData(ampData);
+}
+
+- (void)testQuietRecordingTrimsAsBefore {
+    std::vector<char *> ampData = makeNoisyAmpData(200, 30);
+    setAmpData(ampData, 60, 100, 8000);
+
+    noiseFloorEstimate noise = estimateNoiseFloor(ampData);
+
+    XCTAssertEqual(noise.threshold, 100);
+    XCTAssertEqual(noise.silencePercent, 0.1);
+    XCTAssertTrue(getTrimmingPoints(ampData, noise.threshold, noise.silencePercent) == getTrimmingPoints(ampData));
+    freeAmpData(ampData);
+}
+
+- (void)testQuietDecayingTailEndsAsBefore {
+    // a quiet blow whose amplitude decays exponentially after its peak
+    std::vector<char *> ampData = makeNoisyAmpData(300, 30);
+    for (int i = 60; i < 200; i++) {
+        setAmpData(ampData, i, i + 1, std::max(30, (int) (8000 * exp(-(i - 60) / 10.0))));
+    }
+
+    noiseFloorEstimate noise = estimateNoiseFloor(ampData);
+    std::vector<int> points = getTrimmingPoints(ampData, noise.threshold, noise.silencePercent);
+
+    XCTAssertEqual(noise.silencePercent, 0.1);
+    XCTAssertEqual(points[1], getTrimmingPoints(ampData)[1]);
+    // the tail beneath a tenth of the peak is trimmed
+    XCTAssertLessThan(points[1], 100 * 1024);
+    freeAmpData(ampData);
+}
+
+- (void)testNoisyRecordingTrimsTheNoise {
+    // noise just beneath a tenth of the peak, which the fixed threshold and end rule both keep
+    std::vector<char *> ampData = makeNoisyAmpData(300, 1500);
+    setAmpData(ampData, 140, 200, 13500);
+
+    noiseFloorEstimate noise = estimateNoiseFloor(ampData);
+    std::vector<int> points = getTrimmingPoints(ampData, noise.threshold, noise.silencePercent);
+    std::vector<int> fixedPoints = getTrimmingPoints(ampData);
+
+    XCTAssertGreaterThan(noise.threshold, 1500);
+    XCTAssertGreaterThan(noise.silencePercent, 0.1);
+    XCTAssertEqual(fixedPoints[1], 300 * 1024);
+    // the effort is kept, with its padding, while the noise after it is trimmed
+    XCTAssertLessThanOrEqual(points[0], 140 * 1024);
+    XCTAssertGreaterThanOrEqual(points[0], 130 * 1024);
+    XCTAssertGreaterThanOrEqual(points[1], 200 * 1024);
+    XCTAssertLessThan(points[1], 220 * 1024);
+    freeAmpData(ampData);
+}
+
+- (void)testRecordingThatIsMostlyEffortIsEstimatedFromItsSilence {
+    // a 6 second recording holding a steady 5.2 second blow
+    std::vector<char *> ampData = makeNoisyAmpData(258, 60);
+    setAmpData(ampData, 17, 241, 15000);
+
+    noiseFloorEstimate noise = estimateNoiseFloor(ampData);
+
+    XCTAssertLessThanOrEqual(noise.level, 60);
+    XCTAssertLessThanOrEqual(noise.threshold, 120);
+
+    std::vector<int> points = getTrimmingPoints(ampData, noise.threshold, noise.silencePercent);
+    XCTAssertGreaterThan(points[0], 0);
+    XCTAssertLessThan(points[1], 258 * 1024);
+    freeAmpData(ampData);
+}
+
+- (void)testNoiseLevelWithEffortIsReportedButNotSmoothed {
+    // noise that cannot be told apart from an effort barely above it
+    std::vector<char *> ampData = makeNoisyAmpData(200, 2000);
+    setAmpData(ampData, 60, 100, 3500);
+
+    noiseFloorEstimate noise = estimateNoiseFloor(ampData);
+
+    XCTAssertGreaterThanOrEqual(noise.level, 1800);
+    XCTAssertEqual(noise.threshold, 100);
+    XCTAssertEqual(noise.silencePercent, 0.1);
+    freeAmpData(ampData);
+}
+
+@end
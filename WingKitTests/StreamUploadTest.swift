@@ -0,0 +1,109 @@
+//
+//  StreamUploadTest.swift
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+@testable import WingKit
+import XCTest
+
+class StreamUploadTest: XCTestCase {
+
+    var recordingFilepath: String!
+    var session: URLSession!
+
+    override func setUp() {
+        super.setUp()
+
+        recordingFilepath = SyntheticRecording.temporaryFilepath(named: "upload")
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 200,
+                                 efforts: [SyntheticRecording.Effort(start: 60, end: 100, amplitude: 8000)])
+        session = URLSession(configuration: .ephemeral)
+    }
+
+    override func tearDown() {
+        session.invalidateAndCancel()
+        try? FileManager.default.removeItem(atPath: recordingFilepath)
+        try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+
+        super.tearDown()
+    }
+
+    func upload(_ producer: TrimmedWaveProducer, to url: URL, chunkSize: Int = 1000) -> Error? {
+
+        let completionExpectation = expectation(description: "upload completes")
+        var uploadError: Error?
+
+        Network.uploadStream(from: producer, to: url, using: session, chunkSize: chunkSize) { error in
+            uploadError = error
+            completionExpectation.fulfill()
+        }
+
+        waitForExpectations(timeout: 10)
+        return uploadError
+    }
+
+    func testUploadedBodyMatchesTrimmedFile() {
+
+        guard let listener = LocalHTTPListener() else {
+            XCTFail()
+            return
+        }
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+        XCTAssertNil(upload(producer, to: listener.url))
+
+        guard let request = listener.waitForRequest() else {
+            XCTFail()
+            return
+        }
+
+        XCTAssertEqual(TrimmingWrapper.trim(withInputFileName: recordingFilepath,
+                                            outputFileName: recordingFilepath), 0)
+        let trimmed = FileManager.default.contents(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+
+        XCTAssertEqual(request.method, "PUT")
+        XCTAssertEqual(request.headers["content-type"], "audio/x-wav")
+        XCTAssertEqual(request.headers["content-length"], String(producer.expectedLength()))
+        XCTAssertNil(request.headers["transfer-encoding"])
+        XCTAssertEqual(request.body, trimmed)
+    }
+
+    func testUnacceptableStatusCodeIsReported() {
+
+        guard let listener = LocalHTTPListener(statusCode: 403) else {
+            XCTFail()
+            return
+        }
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+
+        guard let error = upload(producer, to: listener.url) as? NetworkError,
+            case .unacceptableStatusCode(let code) = error else {
+                XCTFail()
+                return
+        }
+
+        XCTAssertEqual(code, 403)
+    }
+
+    func testMissingRecordingFailsWithoutSendingRequest() {
+
+        guard let listener = LocalHTTPListener() else {
+            XCTFail()
+            return
+        }
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath + ".missing")!
+
+        guard let error = upload(producer, to: listener.url) as NSError? else {
+            XCTFail()
+            return
+        }
+
+        XCTAssertEqual(error.domain, TrimmedWaveProducerErrorDomain)
+        XCTAssertEqual(error.code, TrimmedWaveProducerError.openFailed.rawValue)
+        XCTAssertNil(listener.waitForRequest(timeout: 0.5))
+    }
+}
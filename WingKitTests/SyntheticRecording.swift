@@ -0,0 +1,89 @@
+//
+//  SyntheticRecording.swift
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+import Foundation
+
+/// Writes deterministic stereo 16 bit PCM wave files that stand in for recordings made by `TestSessionRecorder`.
+struct SyntheticRecording {
+
+    /// The number of samples per amplitude chunk used by the trimming code.
+    static let chunkSize = 1024
+
+    /// A blow lasting from `start` up to, but excluding, the `end` amplitude chunk.
+    struct Effort {
+        let start: Int
+        let end: Int
+        let amplitude: Double
+    }
+
+    /**
+     Writes a synthetic recording.
+
+     - Parameters:
+        - filepath: The filepath to write the recording to.
+        - chunks: The length of the recording in amplitude chunks.
+        - efforts: The blows contained in the recording.
+        - noise: The amplitude of the uniform background noise.
+     */
+    static func write(toFilepath filepath: String, chunks: Int, efforts: [Effort], noise: Int = 30) {
+
+        var samples = [UInt8]()
+        samples.reserveCapacity(chunks * chunkSize * 4)
+
+        var seed: UInt32 = 1
+        for i in 0..<(chunks * chunkSize) {
+            let chunk = i / chunkSize
+
+            seed = seed &* 1664525 &+ 1013904223
+            var value = Double(Int(seed >> 16) % (2 * noise + 1) - noise)
+            for effort in efforts where effort.start <= chunk && chunk < effort.end {
+                value += effort.amplitude * sin(Double(i) * 0.05)
+            }
+
+            let sample = UInt16(bitPattern: Int16(max(-32768, min(32767, value))))
+            for _ in 0..<2 {
+                samples.append(UInt8(truncatingIfNeeded: sample))
+                samples.append(UInt8(truncatingIfNeeded: sample >> 8))
+            }
+        }
+
+        var bytes = [UInt8]()
+        bytes += Array("RIFF".utf8)
+        bytes += littleEndianBytes(UInt32(36 + samples.count))
+        bytes += Array("WAVEfmt ".utf8)
+        bytes += littleEndianBytes(UInt32(16))
+        bytes += littleEndianBytes(UInt16(1))
+        bytes += littleEndianBytes(UInt16(2))
+        bytes += littleEndianBytes(UInt32(44100))
+        bytes += littleEndianBytes(UInt32(44100 * 4))
+        bytes += littleEndianBytes(UInt16(4))
+        bytes += littleEndianBytes(UInt16(16))
+        bytes += Array("data".utf8)
+        bytes += littleEndianBytes(UInt32(samples.count))
+        bytes += samples
+
+        FileManager.default.createFile(atPath: filepath, contents: Data(bytes: bytes), attributes: nil)
+    }
+
+    /// Returns a filepath in the temporary directory that is unique to the calling test.
+    static func temporaryFilepath(named name: String) -> String {
+        return NSTemporaryDirectory() + "/" + UUID().uuidString + "-" + name + ".wav"
+    }
+
+    /// Returns the filepath `TrimmingWrapper` writes the trimmed version of a recording to.
+    static func trimmedFilepath(for filepath: String) -> String {
+        return String(filepath.dropLast(4)) + "-trimmed.wav"
+    }
+
+    fileprivate static func littleEndianBytes(_ value: UInt32) -> [UInt8] {
+        return (0..<4).map { UInt8(truncatingIfNeeded: value >> (8 * UInt32($0))) }
+    }
+
+    fileprivate static func littleEndianBytes(_ value: UInt16) -> [UInt8] {
+        return (0..<2).map { UInt8(truncatingIfNeeded: value >> (8 * UInt16($0))) }
+    }
+}
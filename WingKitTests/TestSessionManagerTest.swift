@@ -777,6 +777,150 @@ class TestSessionManagerTest: WingKitTestCase {
         XCTAssertEqual(uploadTarget.bucket, expectedUploadTargetBucket)
     }
 
+    func testUploadRecordingStreamingFromProducer() {
+
+        let json: JSON = [
+            TestSession.Keys.id: "testId",
+            TestSession.Keys.patientId: "patientId",
+            TestSession.Keys.startedAt: Date().addingTimeInterval(-8000).iso8601,
+            TestSession.Keys.endedAt: Date().iso8601,
+            TestSession.Keys.lungFunctionZone: LungFunctionZone.greenZone.rawValue,
+            TestSession.Keys.respiratoryState: RespiratoryState.greenZone.rawValue,
+            TestSession.Keys.referenceMetric: ReferenceMetric.pef.rawValue,
+            TestSession.Keys.tests: []
+        ]
+
+        let recordingFilepath = SyntheticRecording.temporaryFilepath(named: "upload")
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 200,
+                                 efforts: [SyntheticRecording.Effort(start: 60, end: 100, amplitude: 8000)])
+        defer {
+            try? FileManager.default.removeItem(atPath: recordingFilepath)
+            try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        }
+
+        let expectedUploadTargetId = "uploadTargetId"
+        let expectedUploadTargetKey = "uploadTargetKey"
+        let expectedUploadTargetBucket = "uploadTargetBucket"
+
+        testSession = createTestSession(with: json)
+        testObject = TestSessionManager(client: client, testSession: testSession)
+
+        client.token = "token"
+
+        mockNetwork.sendRequestStub = { request, completion in
+
+            guard let networkRequest = request as? NetworkRequest else {
+                XCTFail()
+                return
+            }
+
+            switch networkRequest.url.absoluteString {
+            case self.client.baseURLPath + self.createUploadTargetEndpoint().path:
+
+                completion([
+                    UploadTarget.Keys.id: expectedUploadTargetId,
+                    UploadTarget.Keys.key: expectedUploadTargetKey,
+                    UploadTarget.Keys.bucket: expectedUploadTargetBucket
+                    ], nil)
+            default: XCTFail()
+            }
+        }
+
+        // The stub stands in for the upload server, receiving the request body one chunk at a time.
+        var uploadedBody = Data()
+        mockNetwork.uploadStreamStub = { producer, bucket, key, completion in
+
+            XCTAssertEqual(bucket, expectedUploadTargetBucket)
+            XCTAssertEqual(key, expectedUploadTargetKey)
+
+            do {
+                while true {
+                    let chunk = try producer.nextChunk(withMaxLength: 4096)
+                    if chunk.isEmpty { break }
+                    uploadedBody.append(chunk)
+                }
+                XCTAssertEqual(Int64(uploadedBody.count), producer.expectedLength())
+                completion(nil)
+            } catch {
+                completion(error)
+            }
+        }
+
+        let callbackExpectation = expectation(description: "wait for callback")
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+        testObject.uploadRecording(streamingFrom: producer) { (error) in
+
+            if let error = error {
+                XCTFail("Caught unexpected error: \(error)")
+                return
+            }
+
+            callbackExpectation.fulfill()
+        }
+
+        waitForExpectations(timeout: 5, handler: nil)
+
+        XCTAssertEqual(TrimmingWrapper.trim(withInputFileName: recordingFilepath,
+                                            outputFileName: recordingFilepath), 0)
+        XCTAssertEqual(uploadedBody,
+                       FileManager.default.contents(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath)))
+    }
+
+    func testUploadRecordingStreamingFromProducerWhenRecordingIsMissing() {
+
+        let json: JSON = [
+            TestSession.Keys.id: "testId",
+            TestSession.Keys.patientId: "patientId",
+            TestSession.Keys.startedAt: Date().addingTimeInterval(-8000).iso8601,
+            TestSession.Keys.endedAt: Date().iso8601,
+            TestSession.Keys.lungFunctionZone: LungFunctionZone.greenZone.rawValue,
+            TestSession.Keys.respiratoryState: RespiratoryState.greenZone.rawValue,
+            TestSession.Keys.referenceMetric: ReferenceMetric.pef.rawValue,
+            TestSession.Keys.tests: []
+        ]
+
+        testSession = createTestSession(with: json)
+        testObject = TestSessionManager(client: client, testSession: testSession)
+
+        client.token = "token"
+
+        mockNetwork.sendRequestStub = { request, completion in
+            completion([
+                UploadTarget.Keys.id: "uploadTargetId",
+                UploadTarget.Keys.key: "uploadTargetKey",
+                UploadTarget.Keys.bucket: "uploadTargetBucket"
+                ], nil)
+        }
+
+        mockNetwork.uploadStreamStub = { producer, bucket, key, completion in
+            do {
+                _ = try producer.nextChunk(withMaxLength: 4096)
+                completion(nil)
+            } catch {
+                completion(error)
+            }
+        }
+
+        let callbackExpectation = expectation(description: "wait for callback")
+
+        let producer = TrimmedWaveProducer(inputFileName: SyntheticRecording.temporaryFilepath(named: "missing"))!
+        testObject.uploadRecording(streamingFrom: producer) { (error) in
+
+            guard let error = error else {
+                XCTFail()
+                return
+            }
+
+            switch error {
+            case TestSessionManagerError.testUploadFailed: callbackExpectation.fulfill()
+            default: XCTFail("Received unexpected error: \(error)")
+            }
+        }
+
+        waitForExpectations(timeout: 5, handler: nil)
+    }
+
     func testUploadTargetWhenUploadTargetJSONIsUndecodable() {
 
         let json: JSON = [
@@ -43,6 +43,53 @@ class TestSessionRecorderTest: XCTestCase, TestRecorderDelegate {
         XCTAssertEqual(testObject.state, .finished)
     }
 
+    func writeRecording(noise: Int, amplitude: Double) -> String {
+        let documents = NSSearchPathForDirectoriesInDomains(
+            .documentDirectory, FileManager.SearchPathDomainMask.userDomainMask, true)[0]
+        let recordingFilepath = documents + "/wingsampleTest.wav"
+
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 300,
+                                 efforts: [SyntheticRecording.Effort(start: 140, end: 200, amplitude: amplitude)],
+                                 noise: noise)
+
+        return recordingFilepath
+    }
+
+    func testRecordingFilepathEstimatesNoiseFloorWhileTrimming() {
+
+        try? testObject.configure()
+        testObject.stopRecording()
+
+        let recordingFilepath = writeRecording(noise: 1500, amplitude: 12000)
+        defer {
+            try? FileManager.default.removeItem(atPath: recordingFilepath)
+            try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        }
+
+        XCTAssertNil(testObject.recordingNoiseFloor)
+        XCTAssertFalse(testObject.noiseFloorThresholdPassed)
+
+        XCTAssertEqual(testObject.recordingFilepath, SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        XCTAssertEqual(testObject.recordingNoiseFloor ?? 0, 1500, accuracy: 150)
+        XCTAssertTrue(testObject.noiseFloorThresholdPassed)
+    }
+
+    func testNoiseFloorThresholdFailsForLoudRecording() {
+
+        try? testObject.configure()
+        testObject.stopRecording()
+
+        let recordingFilepath = writeRecording(noise: 12000, amplitude: 15000)
+        defer {
+            try? FileManager.default.removeItem(atPath: recordingFilepath)
+            try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        }
+
+        XCTAssertEqual(testObject.recordingFilepath, SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        XCTAssertGreaterThan(testObject.recordingNoiseFloor ?? 0, testObject.noiseFloorThreshold)
+        XCTAssertFalse(testObject.noiseFloorThresholdPassed)
+    }
+
     func recorderStateChanged(_ state: TestRecorderState) {
 
         switch state {
@@ -0,0 +1,94 @@
+//
+//  TrimmedWaveProducerTest.swift
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+@testable import WingKit
+import XCTest
+
+class TrimmedWaveProducerTest: XCTestCase {
+
+    var recordingFilepath: String!
+
+    override func setUp() {
+        super.setUp()
+
+        recordingFilepath = SyntheticRecording.temporaryFilepath(named: "producer")
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 200,
+                                 efforts: [SyntheticRecording.Effort(start: 60, end: 100, amplitude: 8000)])
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(atPath: recordingFilepath)
+        try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+
+        super.tearDown()
+    }
+
+    func drain(_ producer: TrimmedWaveProducer, chunkSize: UInt) throws -> Data {
+        var streamed = Data()
+        while true {
+            let chunk = try producer.nextChunk(withMaxLength: chunkSize)
+            if chunk.isEmpty { break }
+            XCTAssertLessThanOrEqual(chunk.count, Int(chunkSize))
+            streamed.append(chunk)
+        }
+        return streamed
+    }
+
+    func testStreamedBytesMatchTrimmedFile() {
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+
+        guard let streamed = try? drain(producer, chunkSize: 1000) else {
+            XCTFail()
+            return
+        }
+
+        XCTAssertEqual(TrimmingWrapper.trim(withInputFileName: recordingFilepath,
+                                            outputFileName: recordingFilepath), 0)
+
+        let trimmed = FileManager.default.contents(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+
+        XCTAssertEqual(streamed, trimmed)
+        XCTAssertEqual(producer.expectedLength(), Int64(streamed.count))
+    }
+
+    func testHeaderIsSplitAcrossChunksSmallerThanTheHeader() {
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+        let reference = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+
+        XCTAssertEqual(try? drain(producer, chunkSize: 7), try? drain(reference, chunkSize: 64 * 1024))
+    }
+
+    func testNextChunkWithZeroMaxLengthThrows() {
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+
+        do {
+            _ = try producer.nextChunk(withMaxLength: 0)
+            XCTFail()
+        } catch let error as NSError {
+            XCTAssertEqual(error.domain, TrimmedWaveProducerErrorDomain)
+            XCTAssertEqual(error.code, TrimmedWaveProducerError.invalidLength.rawValue)
+        }
+    }
+
+    func testNextChunkThrowsWhenRecordingIsMissing() {
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath + ".missing")!
+
+        XCTAssertEqual(producer.expectedLength(), -1)
+
+        do {
+            _ = try producer.nextChunk(withMaxLength: 1024)
+            XCTFail()
+        } catch let error as NSError {
+            XCTAssertEqual(error.domain, TrimmedWaveProducerErrorDomain)
+            XCTAssertEqual(error.code, TrimmedWaveProducerError.openFailed.rawValue)
+        }
+    }
+}
@@ -0,0 +1,133 @@
+//
+//  TrimmingTestHelpers.h
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+#ifndef TrimmingTestHelpers_h
+#define TrimmingTestHelpers_h
+
+#import <Foundation/Foundation.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Returns a path in the temporary directory that is unique to the calling test.
+static inline std::string temporaryWavePath(const char *name) {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:
+                      [NSString stringWithFormat:@"%@-%s.wav", [NSUUID UUID].UUIDString, name]];
+    return std::string(path.UTF8String);
+}
+
+// Returns the path trim() writes the trimmed version of a recording to.
+static inline std::string trimmedWavePath(const std::string &path) {
+    return path.substr(0, path.size() - 4) + "-trimmed.wav";
+}
+
+// Builds a stereo 16 bit PCM wave file in memory, the same way SyntheticRecording does: 'chunks' amplitude chunks
+// of uniform background noise, with a blow of the given amplitude from chunk 'start' up to, but excluding, chunk
+// 'end'.
+static inline std::vector<char> makeSyntheticWave(int chunks, int start, int end, double amplitude = 8000,
+                                                  int noise = 30) {
+    uint32_t dataSize = (uint32_t) chunks * 1024 * 4;
+    std::vector<char> bytes(44 + dataSize);
+    char *header = bytes.data();
+    uint32_t riffSize = 36 + dataSize, fmtSize = 16, sampleRate = 44100, byteRate = 44100 * 4;
+    uint16_t audioFormat = 1, numChannels = 2, blockAlign = 4, bitsPerSample = 16;
+    memcpy(header, "RIFF", 4);
+    memcpy(header + 4, &riffSize, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &audioFormat, 2);
+    memcpy(header + 22, &numChannels, 2);
+    memcpy(header + 24, &sampleRate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &blockAlign, 2);
+    memcpy(header + 34, &bitsPerSample, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataSize, 4);
+
+    uint32_t seed = 1;
+    for (int i = 0; i < chunks * 1024; i++) {
+        int chunk = i / 1024;
+        seed = seed * 1664525 + 1013904223;
+        double value = (double) ((int) ((seed >> 16) % (2 * noise + 1)) - noise);
+        if (start <= chunk && chunk < end) {
+            value += amplitude * sin(i * 0.05);
+        }
+        int16_t sample = (int16_t) fmax(-32768, fmin(32767, value));
+        memcpy(header + 44 + 4 * i, &sample, 2);
+        memcpy(header + 44 + 4 * i + 2, &sample, 2);
+    }
+    return bytes;
+}
+
+// Writes bytes to a file, replacing it if it exists.
+static inline void writeFileBytes(const std::string &path, const std::vector<char> &bytes) {
+    FILE *file = fopen(path.c_str(), "wb");
+    fwrite(bytes.data(), 1, bytes.size(), file);
+    fclose(file);
+}
+
+// Reads a whole file, or returns no bytes if it cannot be read.
+static inline std::vector<char> readFileBytes(const std::string &path) {
+    std::vector<char> bytes;
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return bytes;
+    }
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    fclose(file);
+    return bytes;
+}
+
+// Builds amplitude data holding 'size' points, all of them 'value'.  The points must be released with freeAmpData.
+static inline std::vector<char *> makeAmpData(int size, int value) {
+    std::vector<char *> ampData(size);
+    for (int i = 0; i < size; i++) {
+        ampData[i] = strdup(std::to_string(value).c_str());
+    }
+    return ampData;
+}
+
+// Builds amplitude data holding 'size' points of background noise.  Like the maxima of the chunks of a recording
+// made in a noisy room, the points lie just beneath 'noise', within a tenth of it.  The points must be released
+// with freeAmpData.
+static inline std::vector<char *> makeNoisyAmpData(int size, int noise) {
+    std::vector<char *> ampData(size);
+    unsigned int seed = 1;
+    for (int i = 0; i < size; i++) {
+        seed = seed * 1664525 + 1013904223;
+        int value = noise - (int) ((seed >> 16) % (noise / 10 + 1));
+        ampData[i] = strdup(std::to_string(value).c_str());
+    }
+    return ampData;
+}
+
+// Sets the amplitude data points from 'start' up to, but excluding, 'end'.
+static inline void setAmpData(std::vector<char *> &ampData, int start, int end, int value) {
+    for (int i = start; i < end; i++) {
+        free(ampData[i]);
+        ampData[i] = strdup(std::to_string(value).c_str());
+    }
+}
+
+// Releases amplitude data built with makeAmpData or makeNoisyAmpData.
+static inline void freeAmpData(std::vector<char *> &ampData) {
+    for (unsigned int i = 0; i < ampData.size(); i++) {
+        free(ampData[i]);
+    }
+    ampData.clear();
+}
+
+#endif /* TrimmingTestHelpers_h */
@@ -0,0 +1,113 @@
+//
+//  TrimmingWrapperTest.swift
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+@testable import WingKit
+import XCTest
+
+class TrimmingWrapperTest: XCTestCase {
+
+    var recordingFilepath: String!
+
+    override func setUp() {
+        super.setUp()
+
+        recordingFilepath = SyntheticRecording.temporaryFilepath(named: "wrapper")
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(atPath: recordingFilepath)
+        try? FileManager.default.removeItem(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        for effort in 1...3 {
+            try? FileManager.default.removeItem(atPath: effortFilepath(effort))
+        }
+
+        super.tearDown()
+    }
+
+    func effortFilepath(_ effort: Int) -> String {
+        return String(recordingFilepath.dropLast(4)) + "-trimmed-\(effort).wav"
+    }
+
+    func testTrimEffortsWritesOneFilePerEffort() {
+
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 600,
+                                 efforts: [SyntheticRecording.Effort(start: 98, end: 196, amplitude: 15000),
+                                           SyntheticRecording.Effort(start: 391, end: 489, amplitude: 15000)])
+
+        var effortCount: Int32 = -1
+        XCTAssertEqual(TrimmingWrapper.trimEfforts(withInputFileName: recordingFilepath,
+                                                   outputFileName: recordingFilepath,
+                                                   effortCount: &effortCount), 0)
+
+        XCTAssertEqual(effortCount, 2)
+        XCTAssertTrue(FileManager.default.fileExists(atPath: effortFilepath(1)))
+        XCTAssertTrue(FileManager.default.fileExists(atPath: effortFilepath(2)))
+        XCTAssertFalse(FileManager.default.fileExists(atPath: effortFilepath(3)))
+    }
+
+    func testTrimEffortsFailsWhenRecordingIsMissing() {
+
+        var effortCount: Int32 = -1
+        XCTAssertEqual(TrimmingWrapper.trimEfforts(withInputFileName: recordingFilepath,
+                                                   outputFileName: recordingFilepath,
+                                                   effortCount: &effortCount), 1)
+
+        XCTAssertEqual(effortCount, 0)
+    }
+
+    func fileSize(atPath path: String) -> Int {
+        return FileManager.default.contents(atPath: path)?.count ?? 0
+    }
+
+    func writeRecordingThatIsMostlyEffort() {
+        // a 6 second recording holding a steady 5.2 second blow
+        SyntheticRecording.write(toFilepath: recordingFilepath, chunks: 258,
+                                 efforts: [SyntheticRecording.Effort(start: 17, end: 241, amplitude: 15000)])
+    }
+
+    func testTrimDropsSilenceOfRecordingThatIsMostlyEffort() {
+
+        writeRecordingThatIsMostlyEffort()
+
+        var noiseFloor = -1.0
+        XCTAssertEqual(TrimmingWrapper.trim(withInputFileName: recordingFilepath,
+                                            outputFileName: recordingFilepath,
+                                            noiseFloor: &noiseFloor), 0)
+
+        XCTAssertGreaterThanOrEqual(noiseFloor, 0)
+        XCTAssertLessThan(noiseFloor, 100)
+        XCTAssertLessThan(fileSize(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath)),
+                          fileSize(atPath: recordingFilepath))
+    }
+
+    func testTrimEffortsFindsEffortOfRecordingThatIsMostlyEffort() {
+
+        writeRecordingThatIsMostlyEffort()
+
+        var effortCount: Int32 = -1
+        XCTAssertEqual(TrimmingWrapper.trimEfforts(withInputFileName: recordingFilepath,
+                                                   outputFileName: recordingFilepath,
+                                                   effortCount: &effortCount), 0)
+
+        XCTAssertEqual(effortCount, 1)
+        XCTAssertLessThan(fileSize(atPath: effortFilepath(1)), fileSize(atPath: recordingFilepath))
+    }
+
+    func testProducerDropsSilenceOfRecordingThatIsMostlyEffort() {
+
+        writeRecordingThatIsMostlyEffort()
+
+        let producer = TrimmedWaveProducer(inputFileName: recordingFilepath)!
+
+        XCTAssertEqual(TrimmingWrapper.trim(withInputFileName: recordingFilepath,
+                                            outputFileName: recordingFilepath), 0)
+
+        let trimmedSize = fileSize(atPath: SyntheticRecording.trimmedFilepath(for: recordingFilepath))
+        XCTAssertEqual(producer.expectedLength(), Int64(trimmedSize))
+        XCTAssertLessThan(trimmedSize, fileSize(atPath: recordingFilepath))
+    }
+}
@@ -0,0 +1,266 @@
+//
+//  WaveIOTest.mm
+//  WingKitTests
+//
+//  Copyright © 2017 Sparo Labs. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TrimmingTestHelpers.h"
+#include "wavdata.h"
+#include "waveIO.h"
+#include "waveTrimming.h"
+
+// A backend that forwards to another backend and counts the requests submitted to it.
+struct countingWaveIOContext {
+    waveIOBackend inner;
+    int submitted;
+};
+
+static int countingOpenFile(void *context, const char *fname, bool forWriting) {
+    countingWaveIOContext *counting = (countingWaveIOContext *) context;
+    return counting->inner.openFile(counting->inner.context, fname, forWriting);
+}
+
+static void countingCloseFile(void *context, int fd) {
+    countingWaveIOContext *counting = (countingWaveIOContext *) context;
+    counting->inner.closeFile(counting->inner.context, fd);
+}
+
+static int countingSubmit(void *context, waveIORequest *request) {
+    countingWaveIOContext *counting = (countingWaveIOContext *) context;
+    counting->submitted += 1;
+    return counting->inner.submit(counting->inner.context, request);
+}
+
+static int countingReap(void *context, waveIORequest **completed, int maxCompleted) {
+    countingWaveIOContext *counting = (countingWaveIOContext *) context;
+    return counting->inner.reap(counting->inner.context, completed, maxCompleted);
+}
+
+// Returns the message of the exception thrown while parsing, or nil if none is thrown.
+static NSString *parseError(const std::vector<char> &bytes, long size) {
+    try {
+        waveFileStruct waveFile = parseWaveData(bytes.data(), size, false);
+        delete[] waveFile.raw_data;
+    } catch (const std::invalid_argument &e) {
+        return @(e.what());
+    }
+    return nil;
+}
+
+@interface WaveIOTest : XCTestCase
+@end
+
+@implementation WaveIOTest {
+    std::vector<std::string> _paths;
+}
+
+- (void)tearDown {
+    for (const std::string &path : _paths) {
+        remove(path.c_str());
+        remove(trimmedWavePath(path).c_str());
+    }
+    _paths.clear();
+    setWaveIOBackend(NULL);
+
+    [super tearDown];
+}
+
+- (std::string)temporaryPath:(const char *)name {
+    std::string path = temporaryWavePath(name);
+    _paths.push_back(path);
+    return path;
+}
+
+- (void)checkRoundTripOnBackend:(waveIOBackend &)io {
+    std::string path = [self temporaryPath:"roundtrip"];
+    std::vector<char> bytes(10000);
+    for (unsigned int i = 0; i < bytes.size(); i++) {
+        bytes[i] = (char) (i * 7);
+    }
+
+    int fd = io.openFile(io.context, path.c_str(), true);
+    XCTAssertGreaterThanOrEqual(fd, 0);
+    XCTAssertEqual(waveIOWrite(io, fd, bytes.data(), 10000, 0), 10000);
+    io.closeFile(io.context, fd);
+
+    fd = io.openFile(io.context, path.c_str(), false);
+    XCTAssertGreaterThanOrEqual(fd, 0);
+    XCTAssertEqual(waveIOFileSize(fd), 10000);
+
+    std::vector<char> read(10000);
+    XCTAssertEqual(waveIORead(io, fd, read.data(), 10000, 0), 10000);
+    XCTAssertTrue(read == bytes);
+    // a read running past the end of the file comes back short
+    XCTAssertEqual(waveIORead(io, fd, read.data(), 100, 9950), 50);
+
+    // several reads queued at once complete independently
+    std::vector<char> parts(10000);
+    waveIORequest requests[4];
+    for (int i = 0; i < 4; i++) {
+        requests[i].fd = fd;
+        requests[i].buffer = parts.data() + 2500 * i;
+        requests[i].nbytes = 2500;
+        requests[i].offset = 2500 * i;
+        requests[i].isWrite = false;
+        requests[i].userData = &requests[i];
+        XCTAssertEqual(io.submit(io.context, &requests[i]), 0);
+    }
+    int completedCount = 0;
+    while (completedCount < 4) {
+        waveIORequest *completed[4];
+        int count = io.reap(io.context, completed, 4);
+        XCTAssertGreaterThan(count, 0);
+        if (count <= 0) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            XCTAssertTrue(completed[i]->done);
+            XCTAssertEqual(completed[i]->result, 2500);
+            XCTAssertEqual(completed[i]->userData, (void *) completed[i]);
+        }
+        completedCount += count;
+    }
+    XCTAssertTrue(parts == bytes);
+
+    waveIORequest *completed[1];
+    XCTAssertEqual(io.reap(io.context, completed, 1), 0);
+    io.closeFile(io.context, fd);
+}
+
+- (void)testPosixBackendRoundTrip {
+    waveIOBackend io;
+    XCTAssertTrue(createPosixWaveIOBackend(io));
+    [self checkRoundTripOnBackend:io];
+    destroyWaveIOBackend(io);
+}
+
+- (void)testIOUringBackendRoundTripWhereAvailable {
+    waveIOBackend io;
+    // io_uring only exists on Linux, elsewhere the backend cannot be created
+    if (!createIOUringWaveIOBackend(io)) {
+        return;
+    }
+    [self checkRoundTripOnBackend:io];
+    destroyWaveIOBackend(io);
+}
+
+- (void)testDefaultBackendRoundTrip {
+    [self checkRoundTripOnBackend:currentWaveIOBackend()];
+}
+
+- (void)testTrimReadsTheRecordingOnceThroughTheInstalledBackend {
+    std::string path = [self temporaryPath:"counted"];
+    writeFileBytes(path, makeSyntheticWave(200, 60, 100));
+
+    countingWaveIOContext counting;
+    XCTAssertTrue(createPosixWaveIOBackend(counting.inner));
+    counting.submitted = 0;
+    waveIOBackend io = {&counting, countingOpenFile, countingCloseFile, countingSubmit, countingReap, NULL};
+
+    setWaveIOBackend(&io);
+    XCTAssertEqual(trim(path, path), 0);
+    // one read of the recording and one write of the trimmed file
+    XCTAssertEqual(counting.submitted, 2);
+
+    setWaveIOBackend(NULL);
+    XCTAssertEqual(trim(path, path), 0);
+    XCTAssertEqual(counting.submitted, 2);
+
+    destroyWaveIOBackend(counting.inner);
+}
+
+- (void)testTrimEffortsReadsTheRecordingOnce {
+    std::string path = [self temporaryPath:"efforts"];
+    writeFileBytes(path, makeSyntheticWave(600, 98, 196, 15000));
+    std::vector<char> bytes = readFileBytes(path);
+    std::vector<char> second = makeSyntheticWave(600, 391, 489, 15000);
+    // add the second effort to the recording
+    for (unsigned int i = 44 + 391 * 1024 * 4; i < 44 + 489 * 1024 * 4; i++) {
+        bytes[i] = second[i];
+    }
+    writeFileBytes(path, bytes);
+
+    countingWaveIOContext counting;
+    XCTAssertTrue(createPosixWaveIOBackend(counting.inner));
+    counting.submitted = 0;
+    waveIOBackend io = {&counting, countingOpenFile, countingCloseFile, countingSubmit, countingReap, NULL};
+
+    setWaveIOBackend(&io);
+    int effortCount = 0;
+    XCTAssertEqual(trimEfforts(path, path, effortCount), 0);
+    XCTAssertEqual(effortCount, 2);
+    // one read of the recording and one write per effort
+    XCTAssertEqual(counting.submitted, 3);
+    setWaveIOBackend(NULL);
+
+    std::string base = path.substr(0, path.size() - 4);
+    remove((base + "-trimmed-1.wav").c_str());
+    remove((base + "-trimmed-2.wav").c_str());
+    destroyWaveIOBackend(counting.inner);
+}
+
+- (void)testParseWaveDataReportsTruncatedAndEmptyFiles {
+    std::vector<char> bytes = makeSyntheticWave(4, 0, 0);
+
+    XCTAssertNil(parseError(bytes, (long) bytes.size()));
+    XCTAssertEqualObjects(parseError(bytes, 20), @"Truncated header");
+    XCTAssertEqualObjects(parseError(bytes, (long) bytes.size() - 100), @"Truncated data");
+
+    std::vector<char> empty(bytes.begin(), bytes.begin() + 44);
+    memset(empty.data() + 40, 0, 4);
+    XCTAssertEqualObjects(parseError(empty, 44), @"No data");
+
+    // filler data running past the end of the file
+    std::vector<char> filler(bytes.begin(), bytes.begin() + 44);
+    memcpy(filler.data() + 36, "FLLR", 4);
+    XCTAssertEqualObjects(parseError(filler, 44), @"Truncated header");
+}
+
+- (void)testReadWaveDataReportsMissingFile {
+    std::string path = [self temporaryPath:"missing"];
+
+    NSString *message = nil;
+    try {
+        readWaveData(path, true);
+    } catch (const std::invalid_argument &e) {
+        message = @(e.what());
+    }
+
+    XCTAssertEqualObjects(message, @"Cannot open file");
+}
+
+- (void)testTrimFilesMatchesTrimAndCountsMissingInput {
+    std::string first = [self temporaryPath:"first"];
+    std::string missing = [self temporaryPath:"missing"];
+    std::string second = [self temporaryPath:"second"];
+    std::string reference = [self temporaryPath:"reference"];
+    writeFileBytes(first, makeSyntheticWave(200, 60, 100));
+    writeFileBytes(second, makeSyntheticWave(200, 120, 170, 12000));
+
+    std::vector<std::string> inputFileNames;
+    inputFileNames.push_back(first);
+    inputFileNames.push_back(missing);
+    inputFileNames.push_back(second);
+    XCTAssertEqual(trimFiles(inputFileNames, 2), 1);
+
+    XCTAssertEqual(trim(first, reference), 0);
+    std::vector<char> trimmed = readFileBytes(trimmedWavePath(first));
+    XCTAssertGreaterThan(trimmed.size(), 44u);
+    XCTAssertTrue(trimmed == readFileBytes(trimmedWavePath(reference)));
+
+    XCTAssertEqual(trim(second, reference), 0);
+    trimmed = readFileBytes(trimmedWavePath(second));
+    XCTAssertGreaterThan(trimmed.size(), 44u);
+    XCTAssertTrue(trimmed == readFileBytes(trimmedWavePath(reference)));
+
+    XCTAssertTrue(readFileBytes(trimmedWavePath(missing)).empty());
+}
+
+@end